@@ -0,0 +1,310 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "../include/bigint.hpp"
+#include "../include/bigint_accumulator.hpp"
+#include "../include/bigint_array.hpp"
+#include "../include/factor.hpp"
+#include "../include/mpn.hpp"
+#include "../include/prepared_multiplier.hpp"
+#include "../include/rns.hpp"
+
+// Operand sizes are given in base-10^9 limbs; operands are drawn uniformly among values of exactly that many limbs,
+// outside the timed loop.
+static BigInt randomOperand(long long limbs, unsigned seed) {
+	std::mt19937_64 engine(seed);
+	BigInt low(1);
+	low.shiftLeft(static_cast<int>(limbs - 1));
+	BigInt span(999999999);
+	span.shiftLeft(static_cast<int>(limbs - 1));
+	return low + BigInt::random_below(span, engine);
+}
+
+static void BM_Add(benchmark::State& state) {
+	BigInt a = randomOperand(state.range(0), 1);
+	BigInt b = randomOperand(state.range(0), 2);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a + b);
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_Add)->RangeMultiplier(8)->Range(1, 1 << 20)->Complexity();
+
+template <BigInt (*Multiply)(const BigInt&, const BigInt&)>
+static void BM_Multiply(benchmark::State& state) {
+	BigInt a = randomOperand(state.range(0), 3);
+	BigInt b = randomOperand(state.range(0), 4);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(Multiply(a, b));
+	}
+	state.SetComplexityN(state.range(0));
+}
+static BigInt multiplyOperator(const BigInt& a, const BigInt& b) { return a * b; }
+// The sub-quadratic paths run up to 2^20 limbs, where one iteration takes from about a second (FFT) to tens of
+// seconds (Karatsuba); the short minimum time keeps those sizes to a single iteration. Schoolbook stops at 2^12.
+BENCHMARK(BM_Multiply<multiplyOperator>)
+    ->Name("BM_Multiply/operator")
+    ->RangeMultiplier(4)
+    ->Range(1, 1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->MinTime(0.1);
+BENCHMARK(BM_Multiply<BigInt::schoolbookMultiply>)
+    ->Name("BM_Multiply/schoolbook")
+    ->RangeMultiplier(4)
+    ->Range(1, 1 << 12)
+    ->Complexity(benchmark::oNSquared);
+BENCHMARK(BM_Multiply<BigInt::karatsuba>)
+    ->Name("BM_Multiply/karatsuba")
+    ->RangeMultiplier(4)
+    ->Range(1, 1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->MinTime(0.1);
+BENCHMARK(BM_Multiply<BigInt::fftMultiply>)
+    ->Name("BM_Multiply/fft")
+    ->RangeMultiplier(4)
+    ->Range(1, 1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->MinTime(0.1)
+    ->Complexity(benchmark::oNLogN);
+
+// The schoolbook base case per Mpn implementation, around KARATSUBA_THRESHOLD where it runs under every recursion.
+static void BM_SchoolbookKernel(benchmark::State& state, const char* implementation) {
+	std::string original = Mpn::implementation();
+	if (!Mpn::use_implementation(implementation)) {
+		state.SkipWithError("not supported on this CPU");
+		return;
+	}
+	BigInt a = randomOperand(state.range(0), 3);
+	BigInt b = randomOperand(state.range(0), 4);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInt::schoolbookMultiply(a, b));
+	}
+	Mpn::use_implementation(original);
+}
+BENCHMARK_CAPTURE(BM_SchoolbookKernel, generic, "generic")->RangeMultiplier(2)->Range(8, 128);
+BENCHMARK_CAPTURE(BM_SchoolbookKernel, bmi2, "bmi2")->RangeMultiplier(2)->Range(8, 128);
+BENCHMARK_CAPTURE(BM_SchoolbookKernel, avx2, "avx2")->RangeMultiplier(2)->Range(8, 128);
+BENCHMARK_CAPTURE(BM_SchoolbookKernel, avx512, "avx512")->RangeMultiplier(2)->Range(8, 128);
+
+// One operand fixed, the other changing every iteration: compare against BM_Multiply/fft at the same size.
+static void BM_PreparedMultiply(benchmark::State& state) {
+	PreparedMultiplier prepared(randomOperand(state.range(0), 3));
+	BigInt b = randomOperand(state.range(0), 4);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(prepared.multiply(b));
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_PreparedMultiply)->RangeMultiplier(4)->Range(1, 1 << 16)->Complexity(benchmark::oNLogN);
+
+// Elementwise addition of many small values: one vector<BigInt> per side against the columnar pool.
+static std::vector<BigInt> randomOperands(long long count, unsigned seed) {
+	std::vector<BigInt> values;
+	values.reserve(static_cast<size_t>(count));
+	for (long long i = 0; i < count; ++i) {
+		values.push_back(randomOperand(1 + i % 4, seed + static_cast<unsigned>(i)));
+	}
+	return values;
+}
+
+static void BM_VectorAdd(benchmark::State& state) {
+	std::vector<BigInt> a = randomOperands(state.range(0), 20);
+	std::vector<BigInt> b = randomOperands(state.range(0), 30);
+	for (auto _ : state) {
+		std::vector<BigInt> sum;
+		sum.reserve(a.size());
+		for (size_t i = 0; i < a.size(); ++i) {
+			sum.push_back(a[i] + b[i]);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VectorAdd)->Arg(1 << 16);
+
+static void BM_ArrayAdd(benchmark::State& state) {
+	BigIntArray a(randomOperands(state.range(0), 20));
+	BigIntArray b(randomOperands(state.range(0), 30));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigIntArray::add(a, b));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArrayAdd)->Arg(1 << 16);
+
+// Summing many small values: BigInt::operator+= against the lazy-carry accumulator.
+static void BM_SumOperator(benchmark::State& state) {
+	std::vector<BigInt> values = randomOperands(state.range(0), 40);
+	for (auto _ : state) {
+		BigInt total;
+		for (const BigInt& value : values) {
+			total += value;
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SumOperator)->Arg(1 << 16);
+
+static void BM_SumAccumulator(benchmark::State& state) {
+	std::vector<BigInt> values = randomOperands(state.range(0), 40);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigIntAccumulator::sum(values));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SumAccumulator)->Arg(1 << 16);
+
+static void BM_DotOperator(benchmark::State& state) {
+	std::vector<BigInt> a = randomOperands(state.range(0), 50);
+	std::vector<BigInt> b = randomOperands(state.range(0), 60);
+	for (auto _ : state) {
+		BigInt total;
+		for (size_t i = 0; i < a.size(); ++i) {
+			total += a[i] * b[i];
+		}
+		benchmark::DoNotOptimize(total);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DotOperator)->Arg(1 << 16);
+
+static void BM_DotAccumulator(benchmark::State& state) {
+	std::vector<BigInt> a = randomOperands(state.range(0), 50);
+	std::vector<BigInt> b = randomOperands(state.range(0), 60);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigIntAccumulator::dot(a, b));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DotAccumulator)->Arg(1 << 16);
+
+// Residue form: a multiply-add costs O(k) lane operations for k primes covering the product, against
+// BM_Multiply/operator at the same size; BM_RnsRoundTrip is the conversion cost paid once per value.
+static void BM_RnsMultiplyAdd(benchmark::State& state) {
+	auto basis = std::make_shared<const RnsBasis>(static_cast<size_t>(state.range(0)) * 60 + 64);
+	RnsInt a(basis, randomOperand(state.range(0), 3));
+	RnsInt b(basis, randomOperand(state.range(0), 4));
+	RnsInt acc(basis, BigInt(0));
+	for (auto _ : state) {
+		acc += a * b;
+		benchmark::DoNotOptimize(acc);
+	}
+	state.counters["primes"] = static_cast<double>(basis->size());
+}
+BENCHMARK(BM_RnsMultiplyAdd)->RangeMultiplier(4)->Range(4, 1 << 10);
+
+static void BM_RnsRoundTrip(benchmark::State& state) {
+	auto basis = std::make_shared<const RnsBasis>(static_cast<size_t>(state.range(0)) * 60 + 64);
+	BigInt a = randomOperand(state.range(0), 3);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(RnsInt(basis, a).to_bigint());
+	}
+}
+BENCHMARK(BM_RnsRoundTrip)->RangeMultiplier(4)->Range(4, 1 << 10);
+
+static void BM_Divide(benchmark::State& state) {
+	BigInt a = randomOperand(2 * state.range(0), 5);
+	BigInt b = randomOperand(state.range(0), 6);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a / b);
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_Divide)->RangeMultiplier(4)->Range(1, 1 << 13)->Complexity(benchmark::oNSquared);
+
+static void BM_ModExp(benchmark::State& state) {
+	BigInt mod = randomOperand(state.range(0), 7);
+	BigInt base = randomOperand(state.range(0), 8) % mod;
+	BigInt exp = randomOperand(state.range(0), 9);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInt::mod_exp(base, exp, mod));
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ModExp)->RangeMultiplier(2)->Range(1, 128)->Unit(benchmark::kMillisecond);
+
+static void BM_ToString(benchmark::State& state) {
+	BigInt a = randomOperand(state.range(0), 10);
+	for (auto _ : state) {
+		std::ostringstream os;
+		os << a;
+		benchmark::DoNotOptimize(os.str());
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ToString)->RangeMultiplier(8)->Range(1, 1 << 20)->Complexity(benchmark::oN);
+
+static void BM_FromString(benchmark::State& state) {
+	std::ostringstream os;
+	os << randomOperand(state.range(0), 11);
+	std::string str = os.str();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInt(str));
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_FromString)->RangeMultiplier(8)->Range(1, 1 << 20)->Complexity(benchmark::oN);
+
+// Reads the top limbs only, so the cost should not grow with the operand; the string route is shown for scale.
+static void BM_ToDouble(benchmark::State& state) {
+	BigInt a = randomOperand(state.range(0), 13);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(a.to_double());
+	}
+}
+BENCHMARK(BM_ToDouble)->RangeMultiplier(8)->Range(1, 32);
+
+static void BM_ToDoubleViaString(benchmark::State& state) {
+	BigInt a = randomOperand(state.range(0), 13);
+	for (auto _ : state) {
+		std::ostringstream os;
+		os << a;
+		benchmark::DoNotOptimize(std::stod(os.str()));
+	}
+}
+BENCHMARK(BM_ToDoubleViaString)->RangeMultiplier(8)->Range(1, 32);
+
+// Operand generation itself, against building the same size from a random decimal string. The first draw at a
+// width computes 2^bits, which is then cached, so it happens before the timed loop.
+static void BM_RandomBits(benchmark::State& state) {
+	std::mt19937_64 engine(12);
+	BigInt::random_bits(static_cast<size_t>(state.range(0)), engine);
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(BigInt::random_bits(static_cast<size_t>(state.range(0)), engine));
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RandomBits)->RangeMultiplier(8)->Range(64, 1 << 23)->Complexity(benchmark::oN);
+
+static void BM_RandomDecimalString(benchmark::State& state) {
+	std::mt19937_64 engine(12);
+	std::uniform_int_distribution<int> digit(0, 9);
+	std::string str(static_cast<size_t>(static_cast<double>(state.range(0)) * 0.30103) + 1, '0');
+	for (auto _ : state) {
+		for (char& c : str) {
+			c = static_cast<char>('0' + digit(engine));
+		}
+		benchmark::DoNotOptimize(BigInt(str));
+	}
+	state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_RandomDecimalString)->RangeMultiplier(8)->Range(64, 1 << 23)->Complexity(benchmark::oN);
+
+// ECM throughput on a 60-digit semiprime with two 30-digit factors, so no curve at this bound succeeds and every
+// curve runs both stages to the end; the argument is the thread count.
+static void BM_EcmCurves(benchmark::State& state) {
+	BigInt n = BigInt("100000000000000000000000000319") * BigInt("1000000000000000000000000000057");
+	const unsigned int curves = 8;
+	for (auto _ : state) {
+		BigInt factor;
+		benchmark::DoNotOptimize(Factorizer::ecm(n, factor, 2000, curves, static_cast<unsigned int>(state.range(0))));
+	}
+	state.SetItemsProcessed(state.iterations() * curves);
+}
+BENCHMARK(BM_EcmCurves)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
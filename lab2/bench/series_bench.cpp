@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "../include/bigfloat.hpp"
+#include "../include/series.hpp"
+
+// End-to-end workload: computes pi (Chudnovsky) and e to the requested number of digits and prints the wall time
+// of every phase, so a regression in operator*, division or decimal output shows up in the phase that uses it.
+//   series_bench [digits = 1000000] [pi | e | all]
+
+class PhaseTimer {
+   public:
+	explicit PhaseTimer(std::string name) : name(std::move(name)), start(std::chrono::steady_clock::now()), total(start) {}
+
+	void phase(const std::string& phase_name) {
+		auto now = std::chrono::steady_clock::now();
+		report(phase_name, now - start);
+		start = now;
+	}
+
+	void finish() { report("total", std::chrono::steady_clock::now() - total); }
+
+   private:
+	std::string name;
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point total;
+
+	void report(const std::string& phase_name, std::chrono::steady_clock::duration elapsed) const {
+		std::cout << std::left << std::setw(4) << name << std::setw(12) << phase_name << std::right << std::fixed
+		          << std::setprecision(3) << std::setw(10) << std::chrono::duration<double>(elapsed).count() << " s\n";
+	}
+};
+
+static std::string decimalDigits(const BigFloat& value, size_t digits, PhaseTimer& timer) {
+	BigInt scaled = (value * BigFloat(BigInt(1), static_cast<long long>(digits) - 1, value.precision())).to_bigint();
+	std::ostringstream out;
+	out << scaled;
+	timer.phase("to_string");
+	return out.str();
+}
+
+static void printDigits(const std::string& str) {
+	const size_t shown = 20;
+	if (str.size() <= 2 * shown) {
+		std::cout << "     " << str << "\n";
+	} else {
+		std::cout << "     " << str.substr(0, shown) << "..." << str.substr(str.size() - shown) << "\n";
+	}
+}
+
+static void runPi(size_t digits) {
+	PhaseTimer timer("pi");
+	HypergeometricSeries series = HypergeometricSeries::chudnovsky();
+	HypergeometricSeries::Split total = series.split(0, series.terms(digits));
+	timer.phase("series");
+
+	size_t precision = digits + 10;
+	BigFloat root = BigFloat::sqrt(BigFloat(10005, precision));
+	timer.phase("sqrt");
+
+	BigFloat pi = BigFloat(total.q * BigInt(426880), precision) * root / BigFloat(total.t, precision);
+	timer.phase("divide");
+
+	std::string str = decimalDigits(pi.with_precision(digits), digits, timer);
+	timer.finish();
+	printDigits(str);
+}
+
+static void runE(size_t digits) {
+	PhaseTimer timer("e");
+	HypergeometricSeries series = HypergeometricSeries::euler();
+	HypergeometricSeries::Split total = series.split(0, series.terms(digits));
+	timer.phase("series");
+
+	size_t precision = digits + 10;
+	BigFloat e = BigFloat(total.t, precision) / BigFloat(total.q, precision);
+	timer.phase("divide");
+
+	std::string str = decimalDigits(e.with_precision(digits), digits, timer);
+	timer.finish();
+	printDigits(str);
+}
+
+int main(int argc, char** argv) {
+	size_t digits = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	std::string which = argc > 2 ? argv[2] : "all";
+	if (digits == 0 || (which != "pi" && which != "e" && which != "all")) {
+		std::cerr << "usage: " << argv[0] << " [digits] [pi|e|all]\n";
+		return 1;
+	}
+	if (which != "e") {
+		runPi(digits);
+	}
+	if (which != "pi") {
+		runE(digits);
+	}
+	return 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bigint.hpp"
+#include "operation_context.hpp"
+
+template <typename T>
+class AsyncOperation {
+   public:
+	AsyncOperation(std::future<T> result, std::shared_ptr<OperationContext> context)
+	    : result(std::move(result)), context(std::move(context)) {}
+
+	// Rethrows whatever the operation threw, OperationCancelled included.
+	T get() { return result.get(); }
+	void wait() const { result.wait(); }
+	bool ready() const { return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+	double progress() const { return context->progress(); }
+	void cancel() const { context->token().cancel(); }
+
+   private:
+	std::future<T> result;
+	std::shared_ptr<OperationContext> context;
+};
+
+// Fixed pool of worker threads running the expensive BigInt operations. Each call copies its operands, queues the
+// work and returns at once; the operation can be watched through progress() and stopped through cancel() or the
+// token passed in, which is honoured both before the task starts and at the checkpoints inside the algorithms.
+class AsyncBigInt {
+   public:
+	explicit AsyncBigInt(unsigned int threads = 0);
+	~AsyncBigInt();
+	AsyncBigInt(const AsyncBigInt&) = delete;
+	AsyncBigInt& operator=(const AsyncBigInt&) = delete;
+
+	AsyncOperation<BigInt> multiply(BigInt num1, BigInt num2, CancellationToken token = CancellationToken());
+	AsyncOperation<BigInt> divide(BigInt num1, BigInt num2, CancellationToken token = CancellationToken());
+	AsyncOperation<BigInt> mod_exp(BigInt base, BigInt exp, BigInt mod, CancellationToken token = CancellationToken());
+	AsyncOperation<std::string> to_string(BigInt num, CancellationToken token = CancellationToken());
+
+   private:
+	std::vector<std::thread> workers;
+	std::queue<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable available;
+	bool stopping = false;
+
+	template <typename T>
+	AsyncOperation<T> submit(std::function<T()> work, CancellationToken token);
+	void run();
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include "bigint.hpp"
+
+class BarrettContext {
+   public:
+	explicit BarrettContext(const BigInt& mod);
+
+	const BigInt& modulus() const;
+	BigInt reduce(const BigInt& value) const;
+	BigInt mul(const BigInt& num1, const BigInt& num2) const;
+	BigInt pow(const BigInt& base, const BigInt& exp) const;
+
+   private:
+	BigInt mod;
+	BigInt mu;
+	BigInt baseK1;
+	size_t k;
+	static BigInt lowDigits(const BigInt& value, size_t count);
+};
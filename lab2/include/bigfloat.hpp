@@ -0,0 +1,74 @@
+#pragma once
+#include <iostream>
+#include <string>
+
+#include "bigint.hpp"
+
+// Arbitrary-precision floating point number mantissa * 10^exponent with a BigInt mantissa of at most
+// `precision` decimal digits. Every operation is correctly rounded (to nearest, ties to even) to the
+// larger precision of its operands.
+class BigFloat {
+   public:
+	BigFloat();
+	BigFloat(long long value, size_t precision = default_precision());
+	explicit BigFloat(const BigInt& value, size_t precision = default_precision());
+	explicit BigFloat(const std::string& str, size_t precision = default_precision());
+	BigFloat(const BigInt& mantissa, long long exponent, size_t precision);
+
+	const BigInt& mantissa() const;
+	long long exponent() const;
+	size_t precision() const;
+	BigFloat with_precision(size_t precision) const;
+	bool is_zero() const;
+
+	BigFloat operator+(const BigFloat& other) const;
+	BigFloat operator-(const BigFloat& other) const;
+	BigFloat operator*(const BigFloat& other) const;
+	BigFloat operator/(const BigFloat& other) const;
+	BigFloat& operator+=(const BigFloat& other);
+	BigFloat& operator-=(const BigFloat& other);
+	BigFloat& operator*=(const BigFloat& other);
+	BigFloat& operator/=(const BigFloat& other);
+
+	bool operator==(const BigFloat& other) const;
+	bool operator!=(const BigFloat& other) const;
+	bool operator<(const BigFloat& other) const;
+	bool operator>(const BigFloat& other) const;
+	bool operator<=(const BigFloat& other) const;
+	bool operator>=(const BigFloat& other) const;
+
+	static BigFloat add(const BigFloat& num1, const BigFloat& num2, size_t precision);
+	static BigFloat sub(const BigFloat& num1, const BigFloat& num2, size_t precision);
+	static BigFloat mul(const BigFloat& num1, const BigFloat& num2, size_t precision);
+	static BigFloat div(const BigFloat& num1, const BigFloat& num2, size_t precision);
+	static BigFloat sqrt(const BigFloat& num, size_t precision);
+	static BigFloat sqrt(const BigFloat& num);
+	static BigFloat reciprocal(const BigFloat& num, size_t precision);
+
+	BigInt to_bigint() const;
+	std::string to_string() const;
+	friend std::ostream& operator<<(std::ostream& os, const BigFloat& num);
+
+	static size_t default_precision();
+	static void set_default_precision(size_t precision);
+
+	inline static const size_t NEWTON_THRESHOLD = 3000;
+
+   private:
+	BigInt mant;
+	long long exp;
+	size_t prec;
+
+	inline static size_t defaultPrecision = 50;
+	inline static const long long GUARD_DIGITS = 10;
+
+	static long long digitCount(const BigInt& num);
+	static void mulPow10(BigInt& num, long long k);
+	static bool divPow10(BigInt& num, long long k);
+	static BigFloat round(BigInt mantissa, long long exponent, size_t precision, bool sticky);
+	static BigFloat estimate(const BigFloat& num, bool inverse_sqrt);
+	static BigFloat newtonReciprocal(const BigFloat& num, size_t digits);
+	static BigFloat newtonInverseSqrt(const BigFloat& num, size_t digits);
+	static int compareMagnitude(const BigFloat& num1, const BigFloat& num2);
+	long long top() const;
+};
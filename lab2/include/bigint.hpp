@@ -2,15 +2,47 @@
 #include <math.h>
 
 #include <compare>
+#include <cstdint>
 #include <complex>
+#include <concepts>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#include "bigint_stats.hpp"
+
+class BarrettContext;
+class FixedBaseExp;
+class BigFloat;
+class PreparedMultiplier;
+class OutOfCoreMultiplier;
+class BigIntArray;
+class BigIntView;
+class BigIntAccumulator;
+class RnsBasis;
+struct BigIntProtocol;
+class Factorizer;
+template <size_t Bits>
+class FixedBigInt;
+
 class BigInt {
    public:
+	using Limbs = std::vector<unsigned long long, LimbAllocator<unsigned long long>>;
+	__extension__ typedef __int128 int128;
+	__extension__ typedef unsigned __int128 uint128;
+
 	BigInt();
 	BigInt(long long value);
+	// Exact; a double is truncated toward zero and NaN or an infinity throws std::invalid_argument. Templates so that
+	// BigInt(7) still resolves to the long long constructor rather than becoming ambiguous.
+	template <class T>
+		requires std::same_as<T, double> || std::same_as<T, int128> || std::same_as<T, uint128>
+	explicit BigInt(T value);
 	explicit BigInt(const std::string& str);
 	BigInt(const BigInt& other);
 	BigInt(BigInt&& other) noexcept;
@@ -45,25 +77,175 @@ class BigInt {
 	friend std::ostream& operator<<(std::ostream& os, const BigInt& num);
 
 	static BigInt mod_exp(const BigInt& base, const BigInt& exp, const BigInt& mod);
+	static BigInt gcd(const BigInt& num1, const BigInt& num2);
+	static BigInt extended_gcd(const BigInt& num1, const BigInt& num2, BigInt& x, BigInt& y);
+	static BigInt mod_inverse(const BigInt& num, const BigInt& mod);
+	static BigInt pow(const BigInt& base, unsigned long long exp);
+	static BigInt isqrt(const BigInt& num);
+	static BigInt sqrtrem(const BigInt& num, BigInt& rem);
+	static BigInt iroot(const BigInt& num, unsigned int k);
+	static BigInt rootrem(const BigInt& num, unsigned int k, BigInt& rem);
+	static BigInt product(std::span<const BigInt> values);
+	static BigInt factorial(unsigned long n);
+	static BigInt binomial(unsigned long n, unsigned long k);
+	static bool is_probable_prime(const BigInt& num, int rounds = 25, bool use_bpsw = false);
+	static BigInt random_prime(size_t bits);
+	// Uniform on [0, bound) for a positive bound, and on [0, 2^bits). Limbs are drawn straight from rng (any
+	// UniformRandomBitGenerator), so a seeded engine reproduces its values without going through strings.
+	template <class Engine>
+	static BigInt random_below(const BigInt& bound, Engine& rng);
+	template <class Engine>
+	static BigInt random_bits(size_t bits, Engine& rng);
+	size_t bit_length() const;
+
+	// Correctly rounded (to nearest, ties to even); values beyond the double range give +-infinity. Reads the top
+	// limbs only, except for values within a hair of a rounding midpoint, which are settled by an exact comparison.
+	double to_double() const;
+	// Checked conversions: throw std::out_of_range when the value does not fit.
+	long long to_int64() const;
+	int128 to_int128() const;
+	// Whether the value is representable in the integral type T (128-bit types included).
+	template <class T>
+	bool fits() const;
+
+	static BigIntStats stats();
+	static void reset_stats();
 	void shiftLeft(int k);
+	static BigInt schoolbookMultiply(const BigInt& num1, const BigInt& num2);
 	static BigInt karatsuba(const BigInt& num1, const BigInt& num2);
 
-	using cd = std::complex<long double>;
+	using cd = std::complex<double>;
 	inline static const double PI = acos(-1.0L);
     static void fft(BigInt& a, bool invert);
     static BigInt fftMultiply(const BigInt& num1, const BigInt& num2);
 
    private:
+	friend class BarrettContext;
+	friend class FixedBaseExp;
+	friend class BigFloat;
+	friend class PreparedMultiplier;
+	friend class OutOfCoreMultiplier;
+	friend class BigIntArray;
+	friend class BigIntView;
+	friend class BigIntAccumulator;
+	friend class RnsBasis;
+	friend struct BigIntProtocol;
+	friend class Factorizer;
+	template <size_t Bits>
+	friend class FixedBigInt;
     static void fftAlgorithm(std::vector<cd>& a, bool invert);
-	static BigInt karatsubaRecursive(BigInt num1, BigInt num2);
-	std::vector<unsigned long long> digits;
+	static size_t fftSize(size_t limbs1, size_t limbs2);
+	static double fftNorm(const Limbs& digits);
+	static bool fftErrorBounded(double norm_product, size_t n);
+	static std::vector<cd> fftSpectrum(const Limbs& digits, size_t n);
+	static Limbs fftInverse(std::vector<cd>& product);
+	static bool fftDigits(const Limbs& num1, const Limbs& num2, Limbs& result);
+	static Limbs schoolbookDigits(const Limbs& a, const Limbs& b);
+	static Limbs karatsubaDigits(const Limbs& num1, const Limbs& num2);
+	static void addDigitsAt(Limbs& acc, const Limbs& value, size_t offset);
+	static void subtractDigits(Limbs& acc, const Limbs& value);
+	static BigInt primeSwing(unsigned long n, const std::vector<unsigned long>& primes);
+	static BigInt factorialRecursive(unsigned long n, const std::vector<unsigned long>& primes);
+	Limbs digits;
 	bool isNegative;
 	inline static const unsigned long long BASE = 1000000000;
 	inline static const int BASE_DIGITS = log10(BASE);
+	inline static const size_t KARATSUBA_THRESHOLD = 128;
+	inline static const size_t FFT_THRESHOLD = 4096;
+	inline static const unsigned long long FFT_BASE = 1000;
+	inline static const size_t FFT_PIECES = 3;
 	void removeLeadingZeros();
 	static bool validateString(const std::string& str);
 	void subtractValue(const BigInt& smaller);
 	void addValue(const BigInt& other);
 	std::strong_ordering compareValue(const BigInt& other) const;
 	bool isNull() const;
+	unsigned long long divSmall(unsigned long long divisor);
+	void mulSmall(unsigned long long factor);
+	static void divModValue(const BigInt& dividend, const BigInt& divisor, BigInt& quotient, BigInt& remainder);
+	static BigInt newtonRoot(const BigInt& num, unsigned int k);
+	unsigned long long toULL() const;
+	bool magnitude128(uint128& magnitude) const;
+	void assignMagnitude(uint128 magnitude);
+	void assignDouble(double value);
+	unsigned long long modSmall(unsigned long long divisor) const;
+	std::vector<uint32_t> toBinaryWords() const;
+	static size_t bitLength(const std::vector<uint32_t>& words);
+	static const BigInt& powerOfTwo(size_t bits);
+	static int jacobiSymbol(long long a, const BigInt& n);
+	static bool strongLucasTest(const BigInt& n, const BarrettContext& ctx);
+	static unsigned long long binaryGcd(unsigned long long a, unsigned long long b);
+	static bool lehmerCofactors(const BigInt& a, const BigInt& b, long long& A, long long& B, long long& C, long long& D);
+	static BigInt linearCombination(long long x, const BigInt& a, long long y, const BigInt& b);
 };
+
+// The top two limbs of bound form a window W < 10^18. The candidate's top two limbs are drawn from [0, W] and the
+// rest uniformly, two limbs per draw, giving a uniform value below (W + 1) * BASE^(size - 2) that is kept only if it
+// is below bound. Only a candidate whose top equals W can be rejected, so a retry is needed less than once in 10^9.
+template <class Engine>
+BigInt BigInt::random_below(const BigInt& bound, Engine& rng) {
+	if (bound.isNegative || bound.isNull()) {
+		throw std::invalid_argument("random_below needs a positive bound");
+	}
+	size_t size = bound.digits.size();
+	if (size == 1) {
+		std::uniform_int_distribution<unsigned long long> value(0, bound.digits[0] - 1);
+		return BigInt(static_cast<long long>(value(rng)));
+	}
+	std::uniform_int_distribution<unsigned long long> top(0, bound.digits[size - 1] * BASE + bound.digits[size - 2]);
+	std::uniform_int_distribution<unsigned long long> pair(0, BASE * BASE - 1);
+	BigInt result;
+	do {
+		result.digits.resize(size);
+		size_t i = 0;
+		for (; i + 3 < size; i += 2) {
+			unsigned long long value = pair(rng);
+			result.digits[i] = value % BASE;
+			result.digits[i + 1] = value / BASE;
+		}
+		if (i + 2 < size) {
+			result.digits[i] = pair(rng) % BASE;
+		}
+		unsigned long long value = top(rng);
+		result.digits[size - 2] = value % BASE;
+		result.digits[size - 1] = value / BASE;
+		result.removeLeadingZeros();
+	} while (result.compareValue(bound) != std::strong_ordering::less);
+	return result;
+}
+
+template <class Engine>
+BigInt BigInt::random_bits(size_t bits, Engine& rng) {
+	return bits == 0 ? BigInt() : random_below(powerOfTwo(bits), rng);
+}
+
+template <class T>
+	requires std::same_as<T, double> || std::same_as<T, BigInt::int128> || std::same_as<T, BigInt::uint128>
+BigInt::BigInt(T value) : isNegative(false) {
+	if constexpr (std::same_as<T, double>) {
+		assignDouble(value);
+	} else if constexpr (std::same_as<T, int128>) {
+		assignMagnitude(value < 0 ? uint128(0) - static_cast<uint128>(value) : static_cast<uint128>(value));
+		isNegative = value < 0;
+	} else {
+		assignMagnitude(value);
+	}
+}
+
+template <class T>
+bool BigInt::fits() const {
+	constexpr bool wide = std::same_as<T, int128> || std::same_as<T, uint128>;
+	static_assert(wide || std::is_integral_v<T>, "fits<T>() needs an integral type");
+	constexpr bool is_signed = std::same_as<T, int128> || (!wide && std::is_signed_v<T>);
+	uint128 max = 0;
+	if constexpr (wide) {
+		max = ~uint128(0) >> (is_signed ? 1 : 0);
+	} else {
+		max = static_cast<uint128>(std::numeric_limits<T>::max());
+	}
+	uint128 magnitude = 0;
+	if (!magnitude128(magnitude)) {
+		return false;
+	}
+	return isNegative ? is_signed && magnitude - 1 <= max : magnitude <= max;
+}
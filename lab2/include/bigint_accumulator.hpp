@@ -0,0 +1,45 @@
+#pragma once
+#include <span>
+#include <vector>
+
+#include "bigint.hpp"
+
+// Running sum of many BigInt terms. Each limb position is a signed 128-bit lane that absorbs additions,
+// subtractions and products limb by limb without carrying; carries are resolved only when the value is read
+// (or, in practice never, when the lanes approach overflow). Products of operands below the Karatsuba threshold
+// go straight into the lanes, so a dot product never materializes its terms.
+class BigIntAccumulator {
+   public:
+	BigIntAccumulator();
+	explicit BigIntAccumulator(const BigInt& initial);
+
+	BigIntAccumulator& operator+=(const BigInt& value);
+	BigIntAccumulator& operator-=(const BigInt& value);
+	// Adds or subtracts num1 * num2, or num * factor.
+	void addmul(const BigInt& num1, const BigInt& num2);
+	void submul(const BigInt& num1, const BigInt& num2);
+	void addmul(const BigInt& num, long long factor);
+
+	BigInt value() const;
+	void clear();
+
+	static BigInt sum(std::span<const BigInt> values);
+	static BigInt dot(std::span<const BigInt> num1, std::span<const BigInt> num2);
+
+   private:
+	using int128 = BigInt::int128;
+	using wide = BigInt::uint128;
+
+	// Lanes hold the value times -1 when negative is set; after normalization every lane is in [0, BASE).
+	mutable std::vector<int128> lanes;
+	mutable bool negative;
+	// Upper bound on the magnitude of any lane.
+	mutable wide bound;
+
+	inline static const wide LANE_LIMIT = static_cast<wide>(1) << 125;
+
+	void reserve(wide growth, size_t size);
+	void addLimbs(const BigInt::Limbs& digits, bool subtract);
+	void addProduct(const BigInt& num1, const BigInt& num2, bool subtract);
+	void normalize() const;
+};
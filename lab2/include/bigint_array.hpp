@@ -0,0 +1,55 @@
+#pragma once
+#include <compare>
+#include <span>
+#include <vector>
+
+#include "bigint.hpp"
+
+// Read-only view of one element of a BigIntArray; valid until the array is modified.
+class BigIntView {
+   public:
+	BigIntView(std::span<const unsigned long long> limbs, bool negative) : digits(limbs), isNegative(negative) {}
+
+	std::span<const unsigned long long> limbs() const { return digits; }
+	bool negative() const { return isNegative; }
+	BigInt to_bigint() const;
+
+	std::strong_ordering operator<=>(const BigIntView& other) const;
+	bool operator==(const BigIntView& other) const;
+
+   private:
+	std::span<const unsigned long long> digits;
+	bool isNegative;
+
+	friend class BigIntArray;
+	static std::strong_ordering compareMagnitude(std::span<const unsigned long long> a, std::span<const unsigned long long> b);
+};
+
+// Many BigInts in columnar form: the limbs of all elements back to back in one pool, element i occupying
+// [offsets[i], offsets[i + 1]), plus one sign byte per element. Elements have BigInt's own normalized limbs, so
+// conversion at the edges is a copy; the elementwise kernels walk the pool sequentially with no per-element allocation.
+class BigIntArray {
+   public:
+	BigIntArray();
+	explicit BigIntArray(const std::vector<BigInt>& values);
+
+	void reserve(size_t count, size_t limbs);
+	void push_back(const BigInt& value);
+	size_t size() const;
+	size_t limb_count() const;
+	BigIntView operator[](size_t index) const;
+	BigInt get(size_t index) const;
+	std::vector<BigInt> to_vector() const;
+
+	static BigIntArray add(const BigIntArray& num1, const BigIntArray& num2);
+	static std::vector<int> compare(const BigIntArray& num1, const BigIntArray& num2);
+	void sort();
+
+   private:
+	std::vector<unsigned long long> pool;
+	std::vector<size_t> offsets;
+	std::vector<unsigned char> signs;
+
+	void append(std::span<const unsigned long long> limbs, bool negative);
+	void appendSum(BigIntView a, BigIntView b);
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bigint_protocol.hpp"
+
+// Client side of BigIntServer. Single operations block for their result and throw std::runtime_error with the
+// server's message on failure. execute() pipelines a whole batch: requests go out WINDOW at a time without waiting
+// and responses are matched back to their calls by id, so the server can coalesce them into its own batches.
+// Not thread-safe; use one client per thread.
+class BigIntClient {
+   public:
+	struct Call {
+		BigIntProtocol::Op op;
+		std::vector<BigInt> args;
+	};
+
+	struct Result {
+		bool ok = false;
+		BigInt value;
+		std::string error;
+		uint64_t latency_ns = 0;
+	};
+
+	explicit BigIntClient(const std::string& path);
+	~BigIntClient();
+	BigIntClient(const BigIntClient&) = delete;
+	BigIntClient& operator=(const BigIntClient&) = delete;
+
+	BigInt add(const BigInt& num1, const BigInt& num2);
+	BigInt sub(const BigInt& num1, const BigInt& num2);
+	BigInt mul(const BigInt& num1, const BigInt& num2);
+	BigInt div(const BigInt& num1, const BigInt& num2);
+	BigInt mod(const BigInt& num1, const BigInt& num2);
+	BigInt gcd(const BigInt& num1, const BigInt& num2);
+	BigInt mod_mul(const BigInt& num1, const BigInt& num2, const BigInt& mod);
+	BigInt mod_exp(const BigInt& base, const BigInt& exp, const BigInt& mod);
+	// The server's per-op latency report (BigIntServer::stats).
+	std::string stats();
+
+	std::vector<Result> execute(const std::vector<Call>& calls);
+	// Server-side latency of the last single operation, queueing included.
+	uint64_t last_latency_ns() const;
+
+   private:
+	int fd;
+	uint32_t nextId = 1;
+	uint64_t lastLatency = 0;
+
+	inline static const size_t WINDOW = 256;
+
+	BigIntProtocol::Response roundTrip(BigIntProtocol::Op op, std::vector<BigInt> args);
+	BigInt call(BigIntProtocol::Op op, std::vector<BigInt> args);
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bigint.hpp"
+
+// Wire format shared by BigIntServer and BigIntClient. Every message is a frame: a little-endian u32 payload length
+// followed by the payload.
+//   request:  u32 id, u8 op, u8 argc, argc BigInts
+//   response: u32 id, u8 status, u64 latency in ns, then a BigInt (Ok) or a u32-length string (Error, Text)
+//   BigInt:   u8 sign, u32 limb count, that many u32 base-10^9 limbs, least significant first
+// Ids are chosen by the client and echoed back; responses on one connection may arrive out of order.
+struct BigIntProtocol {
+	enum Op : uint8_t { Add = 1, Subtract, Multiply, Divide, Modulo, Gcd, ModMul, ModExp, Stats, OpCount };
+	enum Status : uint8_t { Ok = 0, Error, Text };
+
+	struct Request {
+		uint32_t id = 0;
+		Op op = Add;
+		std::vector<BigInt> args;
+	};
+
+	struct Response {
+		uint32_t id = 0;
+		Status status = Ok;
+		uint64_t latency_ns = 0;
+		BigInt value;
+		std::string text;
+	};
+
+	inline static const uint32_t MAX_FRAME = 1u << 26;
+
+	static const char* op_name(Op op);
+	static size_t arity(Op op);
+
+	// Append one complete frame to out.
+	static void encode(const Request& request, std::string& out);
+	static void encode(const Response& response, std::string& out);
+	// Parse a payload (without its length prefix); malformed payloads throw std::invalid_argument.
+	static Request decode_request(std::string_view payload);
+	static Response decode_response(std::string_view payload);
+
+	// Blocking frame I/O on a socket. read_frame returns false on a clean end of stream before a frame starts;
+	// errors, truncated frames and frames above MAX_FRAME throw std::runtime_error.
+	static bool read_frame(int fd, std::string& payload);
+	static void write_all(int fd, std::string_view data);
+
+   private:
+	class Reader;
+	static BigInt readBigInt(Reader& reader);
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <sys/types.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "barrett.hpp"
+#include "bigint_protocol.hpp"
+#include "bigint_stats.hpp"
+
+// BigInt arithmetic served over a Unix domain socket with BigIntProtocol. One reader thread per connection decodes
+// frames into a shared queue; each worker takes up to `batch` queued requests at a time (from any connection),
+// evaluates them and writes the responses back with one send per connection. Modular operations share Barrett
+// contexts through an LRU cache keyed by modulus, so every client benefits from precomputation done for another.
+class BigIntServer {
+   public:
+	struct Options {
+		std::string path;
+		unsigned int threads = 0;
+		size_t batch = 64;
+		size_t contexts = 64;
+		size_t queue_limit = 4096;
+	};
+
+	explicit BigIntServer(Options options);
+	~BigIntServer();
+	BigIntServer(const BigIntServer&) = delete;
+	BigIntServer& operator=(const BigIntServer&) = delete;
+
+	// Binds the socket and starts accepting. A socket file nobody listens on is replaced; a live server's socket or
+	// any other file at the path makes it throw std::system_error, as do other failures.
+	void start();
+	// Also removes the socket file, unless it has since been replaced by something this server did not create.
+	void stop();
+
+	// One line per op that has been served: count, errors and latency (queueing included) as mean and percentiles.
+	std::string stats() const;
+
+   private:
+	struct Connection;
+	struct Pending {
+		std::shared_ptr<Connection> connection;
+		BigIntProtocol::Request request;
+		std::chrono::steady_clock::time_point received;
+	};
+	struct OpStats {
+		uint64_t count = 0;
+		uint64_t errors = 0;
+		uint64_t total_ns = 0;
+		std::array<uint64_t, BigIntStats::LATENCY_BUCKETS> latency{};
+	};
+
+	Options options;
+	int listener = -1;
+	dev_t socketDevice = 0;
+	ino_t socketInode = 0;
+	bool running = false;
+	std::thread acceptor;
+	std::vector<std::thread> workers;
+
+	std::mutex connectionsMutex;
+	std::vector<std::weak_ptr<Connection>> connections;
+	// Reader threads with a flag each sets on exit, so the acceptor can join finished ones as it goes.
+	std::vector<std::pair<std::thread, std::shared_ptr<std::atomic<bool>>>> readers;
+
+	std::mutex queueMutex;
+	std::condition_variable queueReady;
+	std::condition_variable queueSpace;
+	std::deque<Pending> queue;
+	bool stopping = false;
+
+	std::mutex contextMutex;
+	std::list<std::pair<std::string, std::shared_ptr<const BarrettContext>>> contextOrder;
+	std::map<std::string, decltype(contextOrder)::iterator> contextIndex;
+
+	mutable std::mutex statsMutex;
+	std::array<OpStats, BigIntProtocol::OpCount> opStats{};
+
+	void acceptLoop();
+	void readLoop(std::shared_ptr<Connection> connection);
+	void workLoop();
+	BigIntProtocol::Response evaluate(const BigIntProtocol::Request& request);
+	std::shared_ptr<const BarrettContext> context(const BigInt& modulus);
+	void record(BigIntProtocol::Op op, bool failed, uint64_t latency_ns);
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Per-thread BigInt counters. They are only filled in when the library is built with BIGINT_ENABLE_STATS
+// (cmake -DBIGINT_STATS=ON); otherwise BigInt::stats() always reports zeros and the hooks compile to nothing.
+// Operation counts are inclusive: a division that multiplies internally is counted under both.
+struct BigIntStats {
+	enum Operation { Add, Subtract, Multiply, Divide, Modulo, ModExp, Gcd, Root, ToString, FromString, OperationCount };
+	enum Algorithm { Schoolbook, Karatsuba, Fft, KnuthDivision, BarrettReduce, AlgorithmCount };
+
+	// Bucket b holds limb counts in [2^b, 2^(b+1)) and latencies in [2^b, 2^(b+1)) nanoseconds.
+	static constexpr size_t SIZE_BUCKETS = 24;
+	static constexpr size_t LATENCY_BUCKETS = 40;
+	static constexpr uint64_t LATENCY_SAMPLE_PERIOD = 16;
+
+	std::array<uint64_t, OperationCount> calls{};
+	std::array<std::array<uint64_t, SIZE_BUCKETS>, AlgorithmCount> algorithmCalls{};
+	std::array<std::array<uint64_t, LATENCY_BUCKETS>, OperationCount> latency{};
+	uint64_t allocations = 0;
+	uint64_t allocatedBytes = 0;
+
+	static const char* operation_name(Operation op);
+	static const char* algorithm_name(Algorithm algorithm);
+	static size_t bucket(uint64_t value, size_t buckets);
+};
+
+class StatsRecorder {
+   public:
+	static BigIntStats& current();
+	static void allocation(size_t bytes);
+	static void algorithm(BigIntStats::Algorithm algorithm, size_t limbs);
+
+	class Scope {
+	   public:
+		explicit Scope(BigIntStats::Operation op);
+		~Scope();
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	   private:
+		BigIntStats::Operation op;
+		bool sampled;
+		std::chrono::steady_clock::time_point start;
+	};
+};
+
+template <typename T>
+struct CountingAllocator {
+	using value_type = T;
+
+	CountingAllocator() = default;
+	template <typename U>
+	CountingAllocator(const CountingAllocator<U>&) {}
+
+	T* allocate(size_t n) {
+		StatsRecorder::allocation(n * sizeof(T));
+		return std::allocator<T>{}.allocate(n);
+	}
+	void deallocate(T* ptr, size_t n) { std::allocator<T>{}.deallocate(ptr, n); }
+
+	template <typename U>
+	bool operator==(const CountingAllocator<U>&) const {
+		return true;
+	}
+};
+
+#ifdef BIGINT_ENABLE_STATS
+#define BIGINT_STATS_OP(op) StatsRecorder::Scope bigint_stats_scope(BigIntStats::op)
+#define BIGINT_STATS_ALGORITHM(algo, limbs) StatsRecorder::algorithm(BigIntStats::algo, limbs)
+template <typename T>
+using LimbAllocator = CountingAllocator<T>;
+#else
+#define BIGINT_STATS_OP(op) ((void)0)
+#define BIGINT_STATS_ALGORITHM(algo, limbs) ((void)0)
+template <typename T>
+using LimbAllocator = std::allocator<T>;
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+#include <string_view>
+
+#include "bigint.hpp"
+
+// Evaluates one integer expression over BigInt:
+//   expr    := term (('+' | '-') term)*
+//   term    := unary (('*' | '/' | '%') unary)*
+//   unary   := ('-' | '+') unary | power
+//   power   := primary ('^' unary)?
+//   primary := integer | '(' expr ')' | name '(' expr (',' expr)* ')'
+// with the functions pow(b, e), modexp(b, e, m) and gcd(a, b). Division and remainder follow BigInt's operators.
+// Malformed input throws std::invalid_argument; a power whose result would exceed max_bits throws std::length_error,
+// which bounds the memory a single line can claim.
+class Expression {
+   public:
+	static BigInt evaluate(std::string_view text, size_t max_bits = DEFAULT_MAX_BITS);
+
+	inline static const size_t DEFAULT_MAX_BITS = size_t(1) << 26;
+};
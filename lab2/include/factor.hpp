@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "bigint.hpp"
+
+// Integer factorization aimed at numbers of up to about 60 digits. factor() strips primes below trial_limit by trial
+// division and splits perfect powers. It then tries Pollard rho (Brent's variant), which finds factors of up to
+// about 12 digits within its budget, followed by ECM at increasing bounds for larger factors. Rho and ECM do their
+// modular arithmetic on 64-bit words in Montgomery form; ECM runs independent curves on worker threads.
+class Factorizer {
+   public:
+	struct Options {
+		// ECM worker threads; 0 means one per hardware thread.
+		unsigned int threads = 0;
+		uint64_t trial_limit = 1 << 16;
+		uint64_t rho_iterations = 1 << 20;
+		uint64_t seed = 1;
+	};
+
+	// Prime factors of n >= 1 in ascending order, repeated by multiplicity. Throws std::invalid_argument for n < 1 and
+	// std::runtime_error when a composite survives the whole ECM schedule, i.e. when all its factors are well beyond
+	// 30 digits.
+	static std::vector<BigInt> factor(const BigInt& n);
+	static std::vector<BigInt> factor(const BigInt& n, const Options& options);
+
+	// On success each returns true and sets factor to a nontrivial divisor of n. rho stops after `iterations`
+	// evaluations of x^2 + c. ecm tries up to `curves` curves with stage 1 bound b1 (raised to at least ECM_D / 2)
+	// and stage 2 bound 100 * b1. It reports the factor found by the lowest-numbered successful curve, so for a
+	// given seed the result does not depend on the thread count.
+	static bool pollard_rho(const BigInt& n, BigInt& factor, uint64_t iterations, uint64_t seed = 1);
+	static bool ecm(const BigInt& n, BigInt& factor, uint64_t b1, unsigned int curves, unsigned int threads = 0,
+	                uint64_t seed = 1);
+
+	// Stage 2 pairs primes around multiples of ECM_D = 2 * 3 * 5 * 7 * 11.
+	inline static const uint64_t ECM_D = 2310;
+
+   private:
+	class Field;
+	class Curve;
+
+	static std::vector<uint64_t> toWords(const BigInt& value, size_t count);
+	static BigInt fromWords(const std::vector<uint64_t>& words);
+	static bool ecmCurve(const BigInt& n, uint64_t sigma, uint64_t b1, const std::vector<uint32_t>& primes,
+	                     const std::vector<bool>& stage2_primes, const std::atomic<uint64_t>& best, uint64_t curve,
+	                     BigInt& factor);
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+
+#include "barrett.hpp"
+#include "bigint.hpp"
+
+class FixedBaseExp {
+   public:
+	FixedBaseExp(const BigInt& base, const BigInt& mod, size_t max_exp_bits, unsigned int window = 0);
+
+	BigInt pow(const BigInt& exp) const;
+	std::vector<BigInt> pow_batch(const std::vector<BigInt>& exps, unsigned int threads = 0) const;
+
+	const BigInt& modulus() const;
+	size_t max_exp_bits() const;
+
+   private:
+	BarrettContext ctx;
+	BigInt base;
+	unsigned int window;
+	size_t maxBits;
+	std::vector<std::vector<BigInt>> table;
+};
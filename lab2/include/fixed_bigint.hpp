@@ -0,0 +1,242 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <stdexcept>
+
+#include "bigint.hpp"
+
+// Unsigned integer of a fixed width with wrap-around arithmetic. Limbs are little-endian 64-bit words in a
+// std::array, so every loop below has a compile-time trip count and the whole type can be used in constexpr code.
+template <size_t Bits>
+class FixedBigInt {
+	static_assert(Bits > 0 && Bits % 64 == 0, "FixedBigInt width must be a positive multiple of 64");
+
+   public:
+	static constexpr size_t LIMBS = Bits / 64;
+	using Limbs = std::array<uint64_t, LIMBS>;
+
+	constexpr FixedBigInt() : limbs{} {}
+	constexpr FixedBigInt(uint64_t value) : limbs{} { limbs[0] = value; }
+	explicit FixedBigInt(const BigInt& value);
+
+	static constexpr FixedBigInt from_limbs(const Limbs& words) {
+		FixedBigInt result;
+		result.limbs = words;
+		return result;
+	}
+	constexpr const Limbs& to_limbs() const { return limbs; }
+	BigInt to_bigint() const;
+
+	constexpr FixedBigInt& operator+=(const FixedBigInt& other) {
+		add_with_carry(other);
+		return *this;
+	}
+	constexpr FixedBigInt& operator-=(const FixedBigInt& other) {
+		sub_with_borrow(other);
+		return *this;
+	}
+	constexpr FixedBigInt& operator*=(const FixedBigInt& other) {
+		*this = mul_low(*this, other);
+		return *this;
+	}
+	constexpr FixedBigInt& operator/=(const FixedBigInt& other) {
+		FixedBigInt rem;
+		*this = divmod(*this, other, rem);
+		return *this;
+	}
+	constexpr FixedBigInt& operator%=(const FixedBigInt& other) {
+		divmod(*this, other, *this);
+		return *this;
+	}
+	constexpr FixedBigInt& operator<<=(size_t shift) {
+		*this = shifted_left(shift);
+		return *this;
+	}
+	constexpr FixedBigInt& operator>>=(size_t shift) {
+		*this = shifted_right(shift);
+		return *this;
+	}
+
+	constexpr FixedBigInt operator+(const FixedBigInt& other) const { return FixedBigInt(*this) += other; }
+	constexpr FixedBigInt operator-(const FixedBigInt& other) const { return FixedBigInt(*this) -= other; }
+	constexpr FixedBigInt operator*(const FixedBigInt& other) const { return mul_low(*this, other); }
+	constexpr FixedBigInt operator/(const FixedBigInt& other) const { return FixedBigInt(*this) /= other; }
+	constexpr FixedBigInt operator%(const FixedBigInt& other) const { return FixedBigInt(*this) %= other; }
+	constexpr FixedBigInt operator<<(size_t shift) const { return shifted_left(shift); }
+	constexpr FixedBigInt operator>>(size_t shift) const { return shifted_right(shift); }
+
+	constexpr bool operator==(const FixedBigInt& other) const { return limbs == other.limbs; }
+	constexpr std::strong_ordering operator<=>(const FixedBigInt& other) const {
+		for (size_t i = LIMBS; i-- > 0;) {
+			if (limbs[i] != other.limbs[i]) {
+				return limbs[i] < other.limbs[i] ? std::strong_ordering::less : std::strong_ordering::greater;
+			}
+		}
+		return std::strong_ordering::equal;
+	}
+
+	// Adds other in place and returns the carry out of the top limb.
+	constexpr uint64_t add_with_carry(const FixedBigInt& other) {
+		uint64_t carry = 0;
+		for (size_t i = 0; i < LIMBS; ++i) {
+			uint64_t sum = limbs[i] + carry;
+			carry = sum < carry;
+			limbs[i] = sum + other.limbs[i];
+			carry += limbs[i] < sum;
+		}
+		return carry;
+	}
+
+	// Subtracts other in place and returns the borrow out of the top limb.
+	constexpr uint64_t sub_with_borrow(const FixedBigInt& other) {
+		uint64_t borrow = 0;
+		for (size_t i = 0; i < LIMBS; ++i) {
+			uint64_t diff = limbs[i] - other.limbs[i];
+			uint64_t next_borrow = limbs[i] < other.limbs[i];
+			next_borrow += diff < borrow;
+			limbs[i] = diff - borrow;
+			borrow = next_borrow;
+		}
+		return borrow;
+	}
+
+	// Full double-width product.
+	static constexpr FixedBigInt<2 * Bits> mul_wide(const FixedBigInt& num1, const FixedBigInt& num2) {
+		typename FixedBigInt<2 * Bits>::Limbs result{};
+		for (size_t i = 0; i < LIMBS; ++i) {
+			uint64_t carry = 0;
+			for (size_t j = 0; j < LIMBS; ++j) {
+				wide current = static_cast<wide>(num1.limbs[i]) * num2.limbs[j] + result[i + j] + carry;
+				result[i + j] = static_cast<uint64_t>(current);
+				carry = static_cast<uint64_t>(current >> 64);
+			}
+			result[i + LIMBS] = carry;
+		}
+		return FixedBigInt<2 * Bits>::from_limbs(result);
+	}
+
+	// Truncating long division; throws on a zero divisor.
+	static constexpr FixedBigInt divmod(const FixedBigInt& dividend, const FixedBigInt& divisor, FixedBigInt& rem) {
+		if (divisor.is_zero()) {
+			throw std::runtime_error("Division by zero");
+		}
+		FixedBigInt quotient;
+		FixedBigInt current;
+		for (size_t i = dividend.bit_length(); i-- > 0;) {
+			current <<= 1;
+			current.limbs[0] |= (dividend.limbs[i / 64] >> (i % 64)) & 1;
+			if (current >= divisor) {
+				current -= divisor;
+				quotient.limbs[i / 64] |= uint64_t(1) << (i % 64);
+			}
+		}
+		rem = current;
+		return quotient;
+	}
+
+	constexpr bool is_zero() const {
+		for (size_t i = 0; i < LIMBS; ++i) {
+			if (limbs[i] != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr size_t bit_length() const {
+		for (size_t i = LIMBS; i-- > 0;) {
+			if (limbs[i] != 0) {
+				return 64 * i + (64 - std::countl_zero(limbs[i]));
+			}
+		}
+		return 0;
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const FixedBigInt& num) { return os << num.to_bigint(); }
+
+   private:
+	using wide = BigInt::uint128;
+	Limbs limbs;
+
+	static constexpr FixedBigInt mul_low(const FixedBigInt& num1, const FixedBigInt& num2) {
+		FixedBigInt result;
+		for (size_t i = 0; i < LIMBS; ++i) {
+			uint64_t carry = 0;
+			for (size_t j = 0; i + j < LIMBS; ++j) {
+				wide current = static_cast<wide>(num1.limbs[i]) * num2.limbs[j] + result.limbs[i + j] + carry;
+				result.limbs[i + j] = static_cast<uint64_t>(current);
+				carry = static_cast<uint64_t>(current >> 64);
+			}
+		}
+		return result;
+	}
+
+	constexpr FixedBigInt shifted_left(size_t shift) const {
+		FixedBigInt result;
+		size_t words = shift / 64;
+		size_t bits = shift % 64;
+		for (size_t i = LIMBS; i-- > words;) {
+			result.limbs[i] = limbs[i - words] << bits;
+			if (bits != 0 && i > words) {
+				result.limbs[i] |= limbs[i - words - 1] >> (64 - bits);
+			}
+		}
+		return result;
+	}
+
+	constexpr FixedBigInt shifted_right(size_t shift) const {
+		FixedBigInt result;
+		size_t words = shift / 64;
+		size_t bits = shift % 64;
+		for (size_t i = 0; i + words < LIMBS; ++i) {
+			result.limbs[i] = limbs[i + words] >> bits;
+			if (bits != 0 && i + words + 1 < LIMBS) {
+				result.limbs[i] |= limbs[i + words + 1] << (64 - bits);
+			}
+		}
+		return result;
+	}
+};
+
+template <size_t Bits>
+FixedBigInt<Bits>::FixedBigInt(const BigInt& value) : limbs{} {
+	if (value.isNegative) {
+		throw std::out_of_range("Negative BigInt does not fit FixedBigInt");
+	}
+	for (size_t i = value.digits.size(); i-- > 0;) {
+		uint64_t carry = value.digits[i];
+		for (size_t j = 0; j < LIMBS; ++j) {
+			wide current = static_cast<wide>(limbs[j]) * BigInt::BASE + carry;
+			limbs[j] = static_cast<uint64_t>(current);
+			carry = static_cast<uint64_t>(current >> 64);
+		}
+		if (carry != 0) {
+			throw std::out_of_range("BigInt does not fit FixedBigInt");
+		}
+	}
+}
+
+template <size_t Bits>
+BigInt FixedBigInt<Bits>::to_bigint() const {
+	BigInt result;
+	result.digits.clear();
+	Limbs rest = limbs;
+	bool nonzero = !is_zero();
+	while (nonzero) {
+		uint64_t rem = 0;
+		nonzero = false;
+		for (size_t i = LIMBS; i-- > 0;) {
+			wide current = (static_cast<wide>(rem) << 64) | rest[i];
+			rest[i] = static_cast<uint64_t>(current / BigInt::BASE);
+			rem = static_cast<uint64_t>(current % BigInt::BASE);
+			nonzero = nonzero || rest[i] != 0;
+		}
+		result.digits.push_back(rem);
+	}
+	if (result.digits.empty()) {
+		result.digits.push_back(0);
+	}
+	return result;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// mpn-style kernels on raw base-10^9 limb arrays, least significant limb first. Destinations may alias the first
+// source exactly. Multipliers must be below BASE; every routine returns the carry or borrow out of the top limb.
+// The entry points dispatch once, at first use, between a generic build of the kernels, a BMI2 (MULX/SHRX) build,
+// and the BMI2 build with an AVX2 or AVX-512 multiplication base case.
+class Mpn {
+   public:
+	using limb = unsigned long long;
+	inline static const limb BASE = 1000000000ULL;
+
+	// r = a + b and r = a - b over n limbs; the result is a 0/1 carry or borrow.
+	static limb add_n(limb* r, const limb* a, const limb* b, size_t n);
+	static limb sub_n(limb* r, const limb* a, const limb* b, size_t n);
+	// r = a + c and r = a - c for a single limb c, stopping early once the carry or borrow dies out when r == a.
+	static limb add_1(limb* r, const limb* a, size_t n, limb c);
+	static limb sub_1(limb* r, const limb* a, size_t n, limb c);
+	// r = a * b, r += a * b and r -= a * b; the result is the limb that falls off the top.
+	static limb mul_1(limb* r, const limb* a, size_t n, limb b);
+	static limb addmul_1(limb* r, const limb* a, size_t n, limb b);
+	static limb submul_1(limb* r, const limb* a, size_t n, limb b);
+	// r[0..n+m) += a[0..n) * b[0..m): the schoolbook base case. r must not overlap a or b.
+	static limb addmul_rows(limb* r, const limb* a, size_t n, const limb* b, size_t m);
+
+	static std::string implementation();
+	// Switches to "generic", "bmi2", "avx2" or "avx512"; returns false if this CPU cannot run the requested kernels.
+	// The choice is process-wide: it applies to every thread, including operations already running elsewhere, which
+	// pick it up from their next kernel call.
+	static bool use_implementation(const std::string& name);
+};
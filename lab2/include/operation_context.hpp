@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+class OperationCancelled : public std::runtime_error {
+   public:
+	OperationCancelled() : std::runtime_error("Operation cancelled") {}
+};
+
+class CancellationToken {
+   public:
+	CancellationToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+	void cancel() const { flag->store(true, std::memory_order_relaxed); }
+	bool is_cancelled() const { return flag->load(std::memory_order_relaxed); }
+
+   private:
+	std::shared_ptr<std::atomic<bool>> flag;
+};
+
+// Cancellation and progress of one long-running operation. While an Activation is alive the context is attached to
+// the current thread and the algorithms poll it at safe points (multiplication rows and transform stages, quotient
+// limbs, exponent windows, output chunks): a cancelled token makes them throw OperationCancelled before any operand
+// is modified. Algorithms nest, so only the outermost Scope reports its fraction of work done; inner ones just poll.
+class OperationContext {
+   public:
+	explicit OperationContext(CancellationToken token = CancellationToken()) : cancellation(std::move(token)) {}
+
+	const CancellationToken& token() const { return cancellation; }
+	double progress() const { return fraction.load(std::memory_order_relaxed); }
+	void finish() { fraction.store(1.0, std::memory_order_relaxed); }
+
+	class Activation {
+	   public:
+		explicit Activation(OperationContext& context) : previous(active) { active = &context; }
+		~Activation() { active = previous; }
+		Activation(const Activation&) = delete;
+		Activation& operator=(const Activation&) = delete;
+
+	   private:
+		OperationContext* previous;
+	};
+
+	class Scope {
+	   public:
+		Scope() {
+			if (active != nullptr) {
+				++active->depth;
+			}
+		}
+		~Scope() {
+			if (active != nullptr) {
+				--active->depth;
+			}
+		}
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	// fraction < 0 only polls for cancellation.
+	static void checkpoint(double fraction = -1.0) {
+		if (active != nullptr) {
+			active->poll(fraction);
+		}
+	}
+
+   private:
+	CancellationToken cancellation;
+	std::atomic<double> fraction{0.0};
+	int depth = 0;
+
+	inline static thread_local OperationContext* active = nullptr;
+
+	void poll(double value) {
+		if (cancellation.is_cancelled()) {
+			throw OperationCancelled();
+		}
+		if (depth <= 1 && value >= 0) {
+			fraction.store(value, std::memory_order_relaxed);
+		}
+	}
+};
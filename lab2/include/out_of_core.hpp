@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "bigint.hpp"
+
+// Memory mapping of a limb file: the magnitude of a number as raw base-10^9 uint64 limbs, least significant first.
+class LimbFile {
+   public:
+	static LimbFile open(const std::string& path);
+	static LimbFile create(const std::string& path, size_t limbs);
+	// An anonymous scratch file in directory: created with a unique name and unlinked at once, so it never clobbers
+	// an existing file and disappears when the mapping is dropped.
+	static LimbFile temporary(const std::string& directory, size_t limbs);
+
+	LimbFile(LimbFile&& other) noexcept;
+	LimbFile(const LimbFile&) = delete;
+	LimbFile& operator=(const LimbFile&) = delete;
+	LimbFile& operator=(LimbFile&&) = delete;
+	~LimbFile();
+
+	size_t size() const;
+	const uint64_t* data() const;
+	uint64_t* data();
+	void advise(size_t offset, size_t count, int advice) const;
+	void flush(size_t offset, size_t count);
+	void truncate(size_t limbs);
+	// Whether path names this very file (same device and inode); false when path does not exist.
+	bool same_file(const std::string& path) const;
+
+   private:
+	LimbFile(const std::string& path, int fd, size_t limbs, bool writable);
+
+	std::string path;
+	int fd;
+	uint64_t* map;
+	size_t limbs;
+	bool writable;
+};
+
+// Multiplies limb files that do not fit in memory with a four-step number-theoretic transform. The product length
+// is rounded up to L = 2^m and every scratch file is viewed as an R x C matrix, C being the largest power of two up to
+// block_limbs: a transform is one pass over bands of columns (length-R transforms and twiddles) and one over rows
+// (length-C transforms). The convolution is taken modulo two primes near 2^62 whose product exceeds every
+// coefficient, and the final pass recombines the two residues and propagates the carries into the output.
+//
+// Each operand is read once per prime and every pass sweeps its file front to back, so the whole multiply is a fixed
+// number of passes (about twenty over L words) and O(L log L) arithmetic. The next column band is gathered on a
+// helper thread while the current one is transformed, and row passes ask the kernel to read ahead. Scratch space is
+// two anonymous L-limb files in the output's directory; memory holds two bands of at most
+// max(block_limbs, R) limbs.
+class OutOfCoreMultiplier {
+   public:
+	explicit OutOfCoreMultiplier(size_t block_limbs = DEFAULT_BLOCK_LIMBS);
+
+	// Throws std::length_error when the product would need a transform longer than 2^50 limbs and
+	// std::invalid_argument when out_path names one of the inputs.
+	void multiply(const std::string& num1_path, const std::string& num2_path, const std::string& out_path) const;
+
+	static void save(const BigInt& num, const std::string& path);
+	static BigInt load(const std::string& path);
+
+	inline static const size_t DEFAULT_BLOCK_LIMBS = 1 << 20;
+
+   private:
+	class Field;
+
+	size_t blockLimbs;
+
+	void convolve(const LimbFile& num1, const LimbFile& num2, LimbFile& left, LimbFile& right, size_t rows,
+	              size_t columns, const Field& field) const;
+	void columnPass(LimbFile& file, size_t rows, size_t columns, const Field& field, bool inverse) const;
+	void rowPass(LimbFile& file, size_t rows, size_t columns, const Field& field, bool inverse) const;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "bigint.hpp"
+
+// Multiplies one fixed operand by many others through the FFT, keeping the fixed operand's spectrum between calls:
+// each product then costs one forward transform of the other operand and one inverse transform. Spectra are cached
+// per transform size and may be shared by concurrent callers.
+class PreparedMultiplier {
+   public:
+	explicit PreparedMultiplier(const BigInt& operand);
+
+	const BigInt& operand() const;
+	BigInt multiply(const BigInt& other) const;
+
+   private:
+	using Spectrum = std::vector<BigInt::cd>;
+
+	BigInt value;
+	double norm;
+	mutable std::mutex cacheMutex;
+	mutable std::map<size_t, std::shared_ptr<const Spectrum>> spectra;
+
+	std::shared_ptr<const Spectrum> spectrum(size_t n) const;
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "barrett.hpp"
+#include "bigint.hpp"
+
+// A residue number system: k distinct primes below 2^31 whose product M covers the requested number of bits plus
+// a sign. Values are kept modulo every prime at once; conversion in runs a remainder tree down the product tree of
+// the primes, conversion out a CRT combination up the same tree, and values are read back in (-M/2, M/2].
+class RnsBasis {
+   public:
+	explicit RnsBasis(size_t bits);
+
+	size_t size() const;
+	size_t bits() const;
+	const std::vector<uint32_t>& primes() const;
+	const BigInt& modulus() const;
+
+   private:
+	std::vector<uint32_t> moduli;
+	std::vector<double> inverses;
+	// CRT weights (M / p_i)^-1 mod p_i.
+	std::vector<uint32_t> weights;
+	// tree[0] holds the primes, every level above the products of adjacent pairs; tree.back()[0] is M.
+	std::vector<std::vector<BigInt>> tree;
+	// Barrett reducers for the tree nodes at LEAF_LEVEL and above; nodes at LEAF_LEVEL span 2^LEAF_LEVEL primes.
+	std::vector<std::vector<BarrettContext>> reducers;
+	BigInt half;
+
+	inline static const size_t LEAF_LEVEL = 4;
+
+	friend class RnsInt;
+	std::vector<uint32_t> residues(const BigInt& value) const;
+	BigInt reconstruct(const std::vector<uint32_t>& residues) const;
+};
+
+// A BigInt in residue form. Addition, subtraction and multiplication work prime by prime with no carries between
+// lanes, so they cost O(k) regardless of the value; the result is exact as long as it stays within the basis range.
+class RnsInt {
+   public:
+	RnsInt(std::shared_ptr<const RnsBasis> basis, const BigInt& value);
+
+	RnsInt operator+(const RnsInt& other) const;
+	RnsInt operator-(const RnsInt& other) const;
+	RnsInt operator*(const RnsInt& other) const;
+	RnsInt& operator+=(const RnsInt& other);
+	RnsInt& operator-=(const RnsInt& other);
+	RnsInt& operator*=(const RnsInt& other);
+
+	BigInt to_bigint() const;
+	const std::vector<uint32_t>& residues() const;
+	const std::shared_ptr<const RnsBasis>& basis() const;
+
+   private:
+	std::shared_ptr<const RnsBasis> base;
+	std::vector<uint32_t> lanes;
+
+	void checkBasis(const RnsInt& other) const;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include "barrett.hpp"
+#include "bigint.hpp"
+
+// RSA private-key operation in the CRT form of PKCS #1: primes p and q, dP = d mod (p - 1), dQ = d mod (q - 1) and
+// qInv = q^-1 mod p. Two exponentiations modulo the half-size primes replace one modulo n, and the Barrett contexts
+// for p and q are built once per key rather than once per operation.
+class RsaPrivateKey {
+   public:
+	// Throws std::invalid_argument unless p, q > 2 and qInv * q = 1 (mod p).
+	RsaPrivateKey(BigInt p, BigInt q, BigInt d_p, BigInt d_q, BigInt q_inv);
+	// Derives the CRT exponents for public exponent e; throws std::invalid_argument when e is not invertible modulo
+	// p - 1 and q - 1 or when p = q.
+	static RsaPrivateKey from_primes(const BigInt& p, const BigInt& q, const BigInt& e);
+
+	const BigInt& modulus() const;
+
+	// input^d mod n for 0 <= input < n (std::invalid_argument otherwise): m1 = input^dP mod p and m2 = input^dQ mod q,
+	// recombined by Garner's formula m = m2 + q * (qInv * (m1 - m2) mod p). With concurrent set, the half modulo p
+	// runs on a second thread while this one computes the other.
+	BigInt apply(const BigInt& input, bool concurrent = false) const;
+
+   private:
+	BigInt p;
+	BigInt q;
+	BigInt dP;
+	BigInt dQ;
+	BigInt qInv;
+	BigInt n;
+	BarrettContext modP;
+	BarrettContext modQ;
+
+	static BigInt checkedPrime(BigInt p, const BigInt& q, const BigInt& d_p, const BigInt& d_q, const BigInt& q_inv);
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <functional>
+
+#include "bigfloat.hpp"
+#include "bigint.hpp"
+
+// Hypergeometric series S = sum_{k >= 0} a(k) * p(0) * ... * p(k) / (q(0) * ... * q(k)), summed by binary splitting:
+// every range [begin, end) is kept as exact integers P, Q, T with T / Q its partial sum, so the whole evaluation is
+// a balanced tree of big multiplications followed by a single division.
+class HypergeometricSeries {
+   public:
+	using Term = std::function<BigInt(unsigned long long)>;
+
+	struct Split {
+		BigInt p;
+		BigInt q;
+		BigInt t;
+	};
+
+	// log10_ratio(k) estimates log10 |q(k) / p(k)|, the number of digits the k-th term adds; it sizes terms().
+	HypergeometricSeries(Term p, Term q, Term a, std::function<double(unsigned long long)> log10_ratio);
+
+	Split split(unsigned long long begin, unsigned long long end) const;
+	unsigned long long terms(size_t digits) const;
+	BigFloat sum(size_t digits) const;
+
+	static HypergeometricSeries chudnovsky();
+	static HypergeometricSeries euler();
+	static BigFloat pi(size_t digits);
+	static BigFloat e(size_t digits);
+
+   private:
+	Term p;
+	Term q;
+	Term a;
+	std::function<double(unsigned long long)> log10Ratio;
+};
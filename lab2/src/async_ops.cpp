@@ -0,0 +1,81 @@
+#include "../include/async_ops.hpp"
+
+#include <sstream>
+
+AsyncBigInt::AsyncBigInt(unsigned int threads) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	for (unsigned int i = 0; i < threads; ++i) {
+		workers.emplace_back(&AsyncBigInt::run, this);
+	}
+}
+
+// Queued operations still run to completion (or to their cancellation) before the workers are joined.
+AsyncBigInt::~AsyncBigInt() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	available.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+void AsyncBigInt::run() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			available.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty()) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
+
+template <typename T>
+AsyncOperation<T> AsyncBigInt::submit(std::function<T()> work, CancellationToken token) {
+	auto context = std::make_shared<OperationContext>(std::move(token));
+	auto task = std::make_shared<std::packaged_task<T()>>([context, work = std::move(work)] {
+		OperationContext::Activation activation(*context);
+		OperationContext::checkpoint();
+		T result = work();
+		context->finish();
+		return result;
+	});
+	AsyncOperation<T> operation(task->get_future(), context);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.emplace([task] { (*task)(); });
+	}
+	available.notify_one();
+	return operation;
+}
+
+AsyncOperation<BigInt> AsyncBigInt::multiply(BigInt num1, BigInt num2, CancellationToken token) {
+	return submit<BigInt>([num1 = std::move(num1), num2 = std::move(num2)] { return num1 * num2; }, std::move(token));
+}
+
+AsyncOperation<BigInt> AsyncBigInt::divide(BigInt num1, BigInt num2, CancellationToken token) {
+	return submit<BigInt>([num1 = std::move(num1), num2 = std::move(num2)] { return num1 / num2; }, std::move(token));
+}
+
+AsyncOperation<BigInt> AsyncBigInt::mod_exp(BigInt base, BigInt exp, BigInt mod, CancellationToken token) {
+	return submit<BigInt>([base = std::move(base), exp = std::move(exp), mod = std::move(mod)] {
+		return BigInt::mod_exp(base, exp, mod);
+	}, std::move(token));
+}
+
+AsyncOperation<std::string> AsyncBigInt::to_string(BigInt num, CancellationToken token) {
+	return submit<std::string>([num = std::move(num)] {
+		std::ostringstream out;
+		out << num;
+		return out.str();
+	}, std::move(token));
+}
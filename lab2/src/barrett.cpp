@@ -0,0 +1,109 @@
+#include "../include/barrett.hpp"
+#include "../include/operation_context.hpp"
+
+BarrettContext::BarrettContext(const BigInt& modulus) : mod(modulus) {
+	if (mod.isNull()) {
+		throw std::runtime_error("Modulo by zero");
+	}
+	mod.isNegative = false;
+	k = mod.digits.size();
+
+	BigInt base_2k(1);
+	base_2k.shiftLeft(static_cast<int>(2 * k));
+	mu = base_2k / mod;
+	baseK1 = BigInt(1);
+	baseK1.shiftLeft(static_cast<int>(k + 1));
+}
+
+const BigInt& BarrettContext::modulus() const { return mod; }
+
+BigInt BarrettContext::lowDigits(const BigInt& value, size_t count) {
+	if (value.digits.size() <= count) {
+		return value;
+	}
+	BigInt result;
+	result.digits.assign(value.digits.begin(), value.digits.begin() + count);
+	result.removeLeadingZeros();
+	return result;
+}
+
+// HAC 14.42 in base 10^9: valid for 0 <= value < BASE^(2k), anything else goes through operator%.
+BigInt BarrettContext::reduce(const BigInt& value) const {
+	if (value.isNegative || value.digits.size() > 2 * k) {
+		BigInt rem = value % mod;
+		if (rem.isNegative) {
+			rem += mod;
+		}
+		return rem;
+	}
+	if (value.compareValue(mod) == std::strong_ordering::less) {
+		return value;
+	}
+	BIGINT_STATS_ALGORITHM(BarrettReduce, k);
+
+	BigInt q1;
+	q1.digits.assign(value.digits.begin() + (k - 1), value.digits.end());
+	BigInt q2 = q1 * mu;
+	BigInt q3;
+	if (q2.digits.size() > k + 1) {
+		q3.digits.assign(q2.digits.begin() + (k + 1), q2.digits.end());
+	}
+
+	BigInt rem = lowDigits(value, k + 1) - lowDigits(q3 * mod, k + 1);
+	if (rem.isNegative) {
+		rem += baseK1;
+	}
+	while (rem.compareValue(mod) != std::strong_ordering::less) {
+		rem.subtractValue(mod);
+	}
+	return rem;
+}
+
+BigInt BarrettContext::mul(const BigInt& num1, const BigInt& num2) const { return reduce(num1 * num2); }
+
+BigInt BarrettContext::pow(const BigInt& base, const BigInt& exp) const {
+	if (exp.isNegative) {
+		throw std::invalid_argument("Negative exp");
+	}
+	if (mod == BigInt(1)) {
+		return BigInt(0);
+	}
+
+	std::vector<uint32_t> words = exp.toBinaryWords();
+	long long bits = static_cast<long long>(BigInt::bitLength(words));
+	auto bit = [&words](long long i) { return (words[i / 32] >> (i % 32)) & 1; };
+
+	int window = bits > 256 ? 5 : (bits > 32 ? 4 : 1);
+	BigInt normalized = reduce(base);
+	std::vector<BigInt> odd_powers(size_t(1) << (window - 1));
+	odd_powers[0] = normalized;
+	if (odd_powers.size() > 1) {
+		BigInt square = mul(normalized, normalized);
+		for (size_t i = 1; i < odd_powers.size(); ++i) {
+			odd_powers[i] = mul(odd_powers[i - 1], square);
+		}
+	}
+
+	OperationContext::Scope scope;
+	BigInt result(1);
+	for (long long i = bits - 1; i >= 0;) {
+		OperationContext::checkpoint(static_cast<double>(bits - 1 - i) / static_cast<double>(bits));
+		if (!bit(i)) {
+			result = mul(result, result);
+			--i;
+			continue;
+		}
+		long long j = std::max(i - window + 1, 0LL);
+		while (!bit(j)) {
+			++j;
+		}
+		unsigned int value = 0;
+		for (long long t = i; t >= j; --t) {
+			result = mul(result, result);
+			value = (value << 1) | bit(t);
+		}
+		result = mul(result, odd_powers[value >> 1]);
+		i = j - 1;
+	}
+	return result;
+}
@@ -0,0 +1,463 @@
+#include "../include/bigfloat.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using int128 = BigInt::int128;
+
+static const unsigned long long POW10[] = {1,      10,      100,      1000,      10000,
+                                           100000, 1000000, 10000000, 100000000, 1000000000};
+
+// Working precisions for a Newton iteration ending at `digits`, smallest first; the first one is reachable
+// from a long double start value.
+static std::vector<size_t> newtonSteps(size_t digits) {
+	std::vector<size_t> steps;
+	for (size_t current = digits; current > 16; current = current / 2 + 1) {
+		steps.insert(steps.begin(), current);
+	}
+	return steps;
+}
+
+BigFloat::BigFloat() : mant(0), exp(0), prec(defaultPrecision) {}
+
+BigFloat::BigFloat(long long value, size_t precision) : BigFloat(BigInt(value), 0, precision) {}
+
+BigFloat::BigFloat(const BigInt& value, size_t precision) : BigFloat(value, 0, precision) {}
+
+BigFloat::BigFloat(const BigInt& mantissa, long long exponent, size_t precision) {
+	if (precision == 0) {
+		throw std::invalid_argument("Zero precision");
+	}
+	*this = round(mantissa, exponent, precision, false);
+}
+
+BigFloat::BigFloat(const std::string& str, size_t precision) {
+	if (precision == 0) {
+		throw std::invalid_argument("Zero precision");
+	}
+	size_t pos = 0;
+	std::string digits;
+	if (pos < str.size() && (str[pos] == '-' || str[pos] == '+')) {
+		digits += str[pos++];
+	}
+	long long fraction_digits = 0;
+	bool seen_digit = false;
+	bool seen_point = false;
+	for (; pos < str.size() && (isdigit(str[pos]) || (str[pos] == '.' && !seen_point)); ++pos) {
+		if (str[pos] == '.') {
+			seen_point = true;
+			continue;
+		}
+		digits += str[pos];
+		seen_digit = true;
+		fraction_digits += seen_point ? 1 : 0;
+	}
+	if (!seen_digit) {
+		throw std::invalid_argument("Invalid string format for BigFloat construction");
+	}
+
+	long long exponent = 0;
+	if (pos < str.size() && (str[pos] == 'e' || str[pos] == 'E')) {
+		std::string exponent_str = str.substr(pos + 1);
+		size_t parsed = 0;
+		try {
+			exponent = std::stoll(exponent_str, &parsed);
+		} catch (const std::exception&) {
+			throw std::invalid_argument("Invalid string format for BigFloat construction");
+		}
+		pos = str.size() - exponent_str.size() + parsed;
+	}
+	if (pos != str.size()) {
+		throw std::invalid_argument("Invalid string format for BigFloat construction");
+	}
+	*this = round(BigInt(digits), exponent - fraction_digits, precision, false);
+}
+
+const BigInt& BigFloat::mantissa() const { return mant; }
+
+long long BigFloat::exponent() const { return exp; }
+
+size_t BigFloat::precision() const { return prec; }
+
+BigFloat BigFloat::with_precision(size_t precision) const {
+	if (precision == 0) {
+		throw std::invalid_argument("Zero precision");
+	}
+	return round(mant, exp, precision, false);
+}
+
+bool BigFloat::is_zero() const { return mant.isNull(); }
+
+size_t BigFloat::default_precision() { return defaultPrecision; }
+
+void BigFloat::set_default_precision(size_t precision) {
+	if (precision == 0) {
+		throw std::invalid_argument("Zero precision");
+	}
+	defaultPrecision = precision;
+}
+
+long long BigFloat::digitCount(const BigInt& num) {
+	unsigned long long top_limb = num.digits.back();
+	long long count = static_cast<long long>(num.digits.size() - 1) * BigInt::BASE_DIGITS;
+	do {
+		++count;
+		top_limb /= 10;
+	} while (top_limb != 0);
+	return count;
+}
+
+void BigFloat::mulPow10(BigInt& num, long long k) {
+	if (k <= 0 || num.isNull()) {
+		return;
+	}
+	num.shiftLeft(static_cast<int>(k / BigInt::BASE_DIGITS));
+	num.mulSmall(POW10[k % BigInt::BASE_DIGITS]);
+}
+
+// Truncates num / 10^k towards zero and reports whether any non-zero digit was discarded.
+bool BigFloat::divPow10(BigInt& num, long long k) {
+	if (k <= 0) {
+		return false;
+	}
+	size_t limbs = static_cast<size_t>(k / BigInt::BASE_DIGITS);
+	if (limbs >= num.digits.size()) {
+		bool discarded = !num.isNull();
+		num = BigInt(0);
+		return discarded;
+	}
+	bool discarded = false;
+	for (size_t i = 0; i < limbs; ++i) {
+		discarded = discarded || num.digits[i] != 0;
+	}
+	num.digits.erase(num.digits.begin(), num.digits.begin() + limbs);
+	discarded = num.divSmall(POW10[k % BigInt::BASE_DIGITS]) != 0 || discarded;
+	return discarded;
+}
+
+// Rounds mantissa * 10^exponent to `precision` digits, ties to even. `sticky` tells that the exact value
+// lies strictly beyond the given mantissa (in magnitude); callers pass at least precision + 2 digits then.
+BigFloat BigFloat::round(BigInt mantissa, long long exponent, size_t precision, bool sticky) {
+	BigFloat result;
+	result.prec = precision;
+	if (mantissa.isNull()) {
+		return result;
+	}
+
+	long long drop = digitCount(mantissa) - static_cast<long long>(precision);
+	if (drop > 0) {
+		bool rest = divPow10(mantissa, drop - 1);
+		bool negative = mantissa.isNegative;
+		unsigned long long digit = mantissa.divSmall(10);
+		mantissa.isNegative = negative;
+		exponent += drop;
+		bool odd = mantissa.digits[0] % 2 == 1;
+		if (digit > 5 || (digit == 5 && (rest || sticky || odd))) {
+			mantissa += BigInt(negative ? -1 : 1);
+			if (digitCount(mantissa) > static_cast<long long>(precision)) {
+				divPow10(mantissa, 1);
+				++exponent;
+			}
+		}
+	}
+	result.mant = std::move(mantissa);
+	result.exp = exponent;
+	return result;
+}
+
+long long BigFloat::top() const { return exp + digitCount(mant); }
+
+int BigFloat::compareMagnitude(const BigFloat& num1, const BigFloat& num2) {
+	if (num1.is_zero() || num2.is_zero()) {
+		return static_cast<int>(!num1.is_zero()) - static_cast<int>(!num2.is_zero());
+	}
+	if (num1.top() != num2.top()) {
+		return num1.top() < num2.top() ? -1 : 1;
+	}
+	long long common = std::min(num1.exp, num2.exp);
+	BigInt m1 = num1.mant;
+	BigInt m2 = num2.mant;
+	mulPow10(m1, num1.exp - common);
+	mulPow10(m2, num2.exp - common);
+	std::strong_ordering order = m1.compareValue(m2);
+	return order == std::strong_ordering::less ? -1 : (order == std::strong_ordering::greater ? 1 : 0);
+}
+
+BigFloat BigFloat::add(const BigFloat& num1, const BigFloat& num2, size_t precision) {
+	if (num1.is_zero()) {
+		return round(num2.mant, num2.exp, precision, false);
+	}
+	if (num2.is_zero()) {
+		return round(num1.mant, num1.exp, precision, false);
+	}
+	const BigFloat& big = (num1.top() >= num2.top()) ? num1 : num2;
+	const BigFloat& small = (num1.top() >= num2.top()) ? num2 : num1;
+
+	// An operand lying entirely below every digit that can influence rounding only acts as a sticky bit,
+	// so it is replaced by a single unit just under that position instead of being aligned digit by digit.
+	long long cutoff = std::min(big.exp, big.top() - static_cast<long long>(precision) - 3);
+	if (small.top() <= cutoff) {
+		BigInt mantissa = big.mant;
+		mulPow10(mantissa, big.exp - (cutoff - 1));
+		mantissa += BigInt(small.mant.isNegative ? -1 : 1);
+		return round(mantissa, cutoff - 1, precision, false);
+	}
+
+	long long common = std::min(num1.exp, num2.exp);
+	BigInt m1 = num1.mant;
+	BigInt m2 = num2.mant;
+	mulPow10(m1, num1.exp - common);
+	mulPow10(m2, num2.exp - common);
+	return round(m1 + m2, common, precision, false);
+}
+
+BigFloat BigFloat::sub(const BigFloat& num1, const BigFloat& num2, size_t precision) {
+	BigFloat negated = num2;
+	if (!negated.is_zero()) {
+		negated.mant.isNegative = !negated.mant.isNegative;
+	}
+	return add(num1, negated, precision);
+}
+
+BigFloat BigFloat::mul(const BigFloat& num1, const BigFloat& num2, size_t precision) {
+	return round(num1.mant * num2.mant, num1.exp + num2.exp, precision, false);
+}
+
+// Long double start value for 1/x or 1/sqrt(x), good to about 17 digits.
+BigFloat BigFloat::estimate(const BigFloat& num, bool inverse_sqrt) {
+	BigInt top_digits = num.mant;
+	top_digits.isNegative = false;
+	long long scale = num.exp;
+	long long excess = digitCount(top_digits) - 18;
+	if (excess > 0) {
+		divPow10(top_digits, excess);
+	} else {
+		mulPow10(top_digits, -excess);
+	}
+	scale += excess;
+	unsigned long long t = top_digits.toULL();
+
+	if (!inverse_sqrt) {
+		int128 numerator = 1;
+		for (int i = 0; i < 35; ++i) {
+			numerator *= 10;
+		}
+		return BigFloat(BigInt(static_cast<long long>(numerator / t)), -35 - scale, 18);
+	}
+	long double value = static_cast<long double>(t);
+	if (scale % 2 != 0) {
+		value *= 10;
+		--scale;
+	}
+	long long mantissa = std::llround(1e27L / std::sqrt(value));
+	return BigFloat(BigInt(mantissa), -27 - scale / 2, 18);
+}
+
+BigFloat BigFloat::div(const BigFloat& num1, const BigFloat& num2, size_t precision) {
+	if (num2.is_zero()) {
+		throw std::runtime_error("Division by zero");
+	}
+	if (num1.is_zero()) {
+		return BigFloat(0, precision);
+	}
+	bool negative = num1.mant.isNegative != num2.mant.isNegative;
+	BigFloat abs1 = num1;
+	BigFloat abs2 = num2;
+	abs1.mant.isNegative = false;
+	abs2.mant.isNegative = false;
+
+	// |num1 / num2| == n / d * 10^e exactly, with the integer quotient n / d having precision + GUARD_DIGITS digits.
+	long long shift = static_cast<long long>(precision) + GUARD_DIGITS - (digitCount(abs1.mant) - digitCount(abs2.mant));
+	long long e = abs1.exp - abs2.exp - shift;
+	BigInt n = abs1.mant;
+	BigInt d = abs2.mant;
+	if (shift >= 0) {
+		mulPow10(n, shift);
+	} else {
+		mulPow10(d, -shift);
+	}
+
+	BigInt q, r;
+	if (precision >= NEWTON_THRESHOLD) {
+		size_t working = precision + GUARD_DIGITS;
+		BigFloat approx = mul(abs1, newtonReciprocal(abs2, working), working);
+		q = approx.mant;
+		if (approx.exp >= e) {
+			mulPow10(q, approx.exp - e);
+		} else {
+			divPow10(q, e - approx.exp);
+		}
+		r = n - q * d;
+		if (r.isNegative || r >= d) {
+			BigInt delta = r / d;
+			q += delta;
+			r -= delta * d;
+			if (r.isNegative) {
+				--q;
+				r += d;
+			}
+		}
+	} else {
+		BigInt::divModValue(n, d, q, r);
+	}
+
+	if (negative) {
+		q.isNegative = true;
+	}
+	return round(q, e, precision, !r.isNull());
+}
+
+// Newton iteration y <- y + y(1 - xy) with the working precision doubling each step; the result is accurate
+// to a few units in the last of `digits` places, which div then corrects exactly.
+BigFloat BigFloat::newtonReciprocal(const BigFloat& num, size_t digits) {
+	BigFloat y = estimate(num, false);
+	for (size_t working : newtonSteps(digits)) {
+		BigFloat x = round(num.mant, num.exp, working, false);
+		BigFloat error = sub(BigFloat(1, working), mul(x, y, working), working);
+		y = add(y, mul(y, error, working), working);
+	}
+	if (num.mant.isNegative) {
+		y.mant.isNegative = !y.is_zero();
+	}
+	return y;
+}
+
+// Newton iteration y <- y + y(1 - xy^2)/2 for 1/sqrt(x).
+BigFloat BigFloat::newtonInverseSqrt(const BigFloat& num, size_t digits) {
+	const BigFloat half(BigInt(5), -1, 1);
+	BigFloat y = estimate(num, true);
+	for (size_t working : newtonSteps(digits)) {
+		BigFloat x = round(num.mant, num.exp, working, false);
+		BigFloat error = sub(BigFloat(1, working), mul(x, mul(y, y, working), working), working);
+		y = add(y, mul(mul(y, error, working), half, working), working);
+	}
+	return y;
+}
+
+BigFloat BigFloat::reciprocal(const BigFloat& num, size_t precision) { return div(BigFloat(1, precision), num, precision); }
+
+BigFloat BigFloat::sqrt(const BigFloat& num, size_t precision) {
+	if (num.mant.isNegative) {
+		throw std::invalid_argument("Negative radicand");
+	}
+	if (num.is_zero()) {
+		return BigFloat(0, precision);
+	}
+
+	// sqrt(num) == sqrt(n) * 10^e with n having 2 * (precision + GUARD_DIGITS) or one more digits.
+	long long shift = 2 * (static_cast<long long>(precision) + GUARD_DIGITS) - digitCount(num.mant);
+	if ((num.exp - shift) % 2 != 0) {
+		++shift;
+	}
+	long long e = (num.exp - shift) / 2;
+	BigInt n = num.mant;
+	bool sticky = false;
+	if (shift >= 0) {
+		mulPow10(n, shift);
+	} else {
+		sticky = divPow10(n, -shift);
+	}
+
+	BigInt root, rem;
+	if (precision >= NEWTON_THRESHOLD) {
+		size_t working = precision + GUARD_DIGITS;
+		BigFloat approx = mul(num, newtonInverseSqrt(num, working), working);
+		root = approx.mant;
+		if (approx.exp >= e) {
+			mulPow10(root, approx.exp - e);
+		} else {
+			divPow10(root, e - approx.exp);
+		}
+		rem = n - root * root;
+		BigInt delta = rem / (root + root);
+		if (!delta.isNull()) {
+			root += delta;
+			rem = n - root * root;
+		}
+		while (rem.isNegative) {
+			--root;
+			rem += root + root + BigInt(1);
+		}
+		while (rem > root + root) {
+			rem -= root + root + BigInt(1);
+			++root;
+		}
+	} else {
+		root = BigInt::sqrtrem(n, rem);
+	}
+	return round(root, e, precision, sticky || !rem.isNull());
+}
+
+BigFloat BigFloat::sqrt(const BigFloat& num) { return sqrt(num, num.prec); }
+
+BigFloat BigFloat::operator+(const BigFloat& other) const { return add(*this, other, std::max(prec, other.prec)); }
+
+BigFloat BigFloat::operator-(const BigFloat& other) const { return sub(*this, other, std::max(prec, other.prec)); }
+
+BigFloat BigFloat::operator*(const BigFloat& other) const { return mul(*this, other, std::max(prec, other.prec)); }
+
+BigFloat BigFloat::operator/(const BigFloat& other) const { return div(*this, other, std::max(prec, other.prec)); }
+
+BigFloat& BigFloat::operator+=(const BigFloat& other) { return *this = *this + other; }
+
+BigFloat& BigFloat::operator-=(const BigFloat& other) { return *this = *this - other; }
+
+BigFloat& BigFloat::operator*=(const BigFloat& other) { return *this = *this * other; }
+
+BigFloat& BigFloat::operator/=(const BigFloat& other) { return *this = *this / other; }
+
+bool BigFloat::operator==(const BigFloat& other) const {
+	return mant.isNegative == other.mant.isNegative && compareMagnitude(*this, other) == 0;
+}
+
+bool BigFloat::operator!=(const BigFloat& other) const { return !(*this == other); }
+
+bool BigFloat::operator<(const BigFloat& other) const {
+	if (mant.isNegative != other.mant.isNegative) {
+		return mant.isNegative;
+	}
+	int order = compareMagnitude(*this, other);
+	return mant.isNegative ? order > 0 : order < 0;
+}
+
+bool BigFloat::operator>(const BigFloat& other) const { return other < *this; }
+
+bool BigFloat::operator<=(const BigFloat& other) const { return !(other < *this); }
+
+bool BigFloat::operator>=(const BigFloat& other) const { return !(*this < other); }
+
+BigInt BigFloat::to_bigint() const {
+	BigInt result = mant;
+	if (exp >= 0) {
+		mulPow10(result, exp);
+	} else {
+		divPow10(result, -exp);
+	}
+	return result;
+}
+
+std::string BigFloat::to_string() const {
+	if (is_zero()) {
+		return "0";
+	}
+	std::ostringstream digits;
+	BigInt magnitude = mant;
+	magnitude.isNegative = false;
+	digits << magnitude;
+	std::string str = digits.str();
+	while (str.size() > 1 && str.back() == '0') {
+		str.pop_back();
+	}
+
+	std::string result = mant.isNegative ? "-" : "";
+	result += str[0];
+	if (str.size() > 1) {
+		result += '.';
+		result += str.substr(1);
+	}
+	return result + "e" + std::to_string(top() - 1);
+}
+
+std::ostream& operator<<(std::ostream& os, const BigFloat& num) { return os << num.to_string(); }
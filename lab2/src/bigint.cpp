@@ -1,4 +1,10 @@
 #include "../include/bigint.hpp"
+#include "../include/barrett.hpp"
+#include "../include/mpn.hpp"
+#include "../include/operation_context.hpp"
+
+#include <cmath>
+#include <cstdlib>
 
 bool BigInt::validateString(const std::string& str) {
 	if (str.empty()) {
@@ -36,40 +42,24 @@ void BigInt::removeLeadingZeros() {
 }
 
 void BigInt::subtractValue(const BigInt& smaller) {
-	long long borrow = 0;
 	size_t n = digits.size();
 	size_t m = smaller.digits.size();
-
-	for (size_t i = 0; i < n; ++i) {
-		long long current_this_digit = digits[i];
-		long long current_smaller_digit = (i < m) ? smaller.digits[i] : 0;
-		long long diff = current_this_digit - current_smaller_digit - borrow;
-
-		if (diff < 0) {
-			diff += BASE;
-			borrow = 1;
-		} else {
-			borrow = 0;
-		}
-		digits[i] = static_cast<unsigned long long>(diff);
-	}
+	unsigned long long borrow = Mpn::sub_n(digits.data(), digits.data(), smaller.digits.data(), m);
+	Mpn::sub_1(digits.data() + m, digits.data() + m, n - m, borrow);
 	removeLeadingZeros();
 }
+
 void BigInt::addValue(const BigInt& other) {
-	unsigned long long carry = 0;
 	size_t n = digits.size();
 	size_t m = other.digits.size();
-	size_t max_len = std::max(n, m);
-	digits.resize(max_len, 0);
-
-	for (size_t i = 0; i < max_len || carry != 0; ++i) {
-		if (i == digits.size()) {
-			digits.push_back(0);
-		}
-		unsigned long long other_digit = (i < m) ? other.digits[i] : 0;
-		unsigned long long currentSum = digits[i] + other_digit + carry;
-		digits[i] = currentSum % BASE;
-		carry = currentSum / BASE;
+	if (n < m) {
+		digits.insert(digits.end(), other.digits.begin() + n, other.digits.end());
+	}
+	size_t common = std::min(n, m);
+	unsigned long long carry = Mpn::add_n(digits.data(), digits.data(), other.digits.data(), common);
+	carry = Mpn::add_1(digits.data() + common, digits.data() + common, digits.size() - common, carry);
+	if (carry != 0) {
+		digits.push_back(carry);
 	}
 }
 
@@ -97,22 +87,43 @@ std::strong_ordering BigInt::compareValue(const BigInt& other) const {
 
 BigInt::BigInt() : isNegative(false) { digits.push_back(0); }
 
-BigInt::BigInt(long long value) : isNegative(false) {
-	if (value == 0) {
-		digits.push_back(0);
-	} else {
-		if (value < 0) {
-			isNegative = true;
-			value = -value;
-		}
+// The magnitude is taken in unsigned arithmetic so that LLONG_MIN does not overflow on negation.
+BigInt::BigInt(long long value) : isNegative(value < 0) {
+	unsigned long long magnitude =
+	    value < 0 ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+	do {
+		digits.push_back(magnitude % BASE);
+		magnitude /= BASE;
+	} while (magnitude > 0);
+}
+
+void BigInt::assignMagnitude(uint128 magnitude) {
+	digits.clear();
+	do {
+		digits.push_back(static_cast<unsigned long long>(magnitude % BASE));
+		magnitude /= BASE;
+	} while (magnitude > 0);
+}
+
+// value = mantissa * 2^exponent with a 53-bit mantissa; anything below 2^64 converts directly.
+void BigInt::assignDouble(double value) {
+	if (!std::isfinite(value)) {
+		throw std::invalid_argument("Cannot construct BigInt from NaN or infinity");
 	}
-	while (value > 0) {
-		digits.push_back(static_cast<unsigned long long>(value % BASE));
-		value /= BASE;
+	double magnitude = std::trunc(std::fabs(value));
+	if (magnitude < 0x1p64) {
+		assignMagnitude(static_cast<unsigned long long>(magnitude));
+	} else {
+		int exponent = 0;
+		double fraction = std::frexp(magnitude, &exponent);
+		assignMagnitude(static_cast<unsigned long long>(std::ldexp(fraction, 53)));
+		*this *= pow(BigInt(2), static_cast<unsigned long long>(exponent - 53));
 	}
+	isNegative = value < 0 && !isNull();
 }
 
 BigInt::BigInt(const std::string& str) : isNegative(false) {
+	BIGINT_STATS_OP(FromString);
 	if (!validateString(str)) {
 		throw std::invalid_argument("Invalid string format for BigInt construction");
 	}
@@ -180,6 +191,7 @@ BigInt& BigInt::operator=(BigInt&& other) noexcept {
 }
 
 BigInt& BigInt::operator+=(const BigInt& other) {
+	BIGINT_STATS_OP(Add);
 	if (isNegative == other.isNegative) {
 		addValue(other);
 	} else {
@@ -202,6 +214,7 @@ BigInt& BigInt::operator+=(const BigInt& other) {
 }
 
 BigInt& BigInt::operator-=(const BigInt& other) {
+	BIGINT_STATS_OP(Subtract);
 	BigInt temp = other;
 	if (!(temp.isNull())) {
 		temp.isNegative = !temp.isNegative;
@@ -238,7 +251,23 @@ BigInt BigInt::operator--(int) {
 	return temp;
 }
 
+BigInt::Limbs BigInt::schoolbookDigits(const Limbs& a, const Limbs& b) {
+	size_t n = a.size();
+	size_t m = b.size();
+	BIGINT_STATS_ALGORITHM(Schoolbook, std::max(n, m));
+	OperationContext::Scope scope;
+	Limbs result_digits(n + m, 0);
+
+	for (size_t i = 0; i < n; i += 16) {
+		OperationContext::checkpoint(static_cast<double>(i) / static_cast<double>(n));
+		size_t rows = std::min<size_t>(16, n - i);
+		Mpn::addmul_rows(result_digits.data() + i, a.data() + i, rows, b.data(), m);
+	}
+	return result_digits;
+}
+
 BigInt& BigInt::operator*=(const BigInt& other) {
+	BIGINT_STATS_OP(Multiply);
 	bool this_is_zero = isNull();
 	bool other_is_zero = other.isNull();
 	if (this_is_zero || other_is_zero) {
@@ -248,91 +277,133 @@ BigInt& BigInt::operator*=(const BigInt& other) {
 
 	bool result_is_negative = (isNegative != other.isNegative);
 
-	size_t n = digits.size();
-	size_t m = other.digits.size();
-	std::vector<unsigned long long> result_digits(n + m, 0);
-
-	for (size_t i = 0; i < n; ++i) {
-		unsigned long long carry = 0;
-		for (size_t j = 0; j < m || carry != 0; ++j) {
-			unsigned long long current_other_digit = (j < m) ? other.digits[j] : 0;
-			unsigned long long current_product = result_digits[i + j] + digits[i] * current_other_digit + carry;
-			result_digits[i + j] = current_product % BASE;
-			carry = current_product / BASE;
-		}
+	size_t shorter = std::min(digits.size(), other.digits.size());
+	Limbs product;
+	if (shorter < KARATSUBA_THRESHOLD) {
+		digits = schoolbookDigits(digits, other.digits);
+	} else if (shorter >= FFT_THRESHOLD && fftDigits(digits, other.digits, product)) {
+		digits = std::move(product);
+	} else {
+		digits = karatsubaDigits(digits, other.digits);
 	}
-
 	isNegative = result_is_negative;
-	digits = std::move(result_digits);
 
 	removeLeadingZeros();
 
 	return *this;
 }
 
-BigInt& BigInt::operator/=(const BigInt& other) {
-	if (other.isNull()) {
-		throw std::runtime_error("Division by zero");
+unsigned long long BigInt::divSmall(unsigned long long divisor) {
+	unsigned long long rem = 0;
+	for (size_t i = digits.size(); i-- > 0;) {
+		unsigned long long current = digits[i] + rem * BASE;
+		digits[i] = current / divisor;
+		rem = current % divisor;
 	}
+	removeLeadingZeros();
+	return rem;
+}
 
-	bool this_is_zero = isNull();
-	if (this_is_zero) {
-		return *this;
+void BigInt::mulSmall(unsigned long long factor) {
+	if (factor < BASE) {
+		unsigned long long carry = Mpn::mul_1(digits.data(), digits.data(), digits.size(), factor);
+		if (carry != 0) {
+			digits.push_back(carry);
+		}
+		removeLeadingZeros();
+		return;
 	}
-
-	std::strong_ordering value_cmp = compareValue(other);
-
-	if (value_cmp == std::strong_ordering::less) {
-		*this = BigInt(0);
-		return *this;
+	unsigned long long carry = 0;
+	for (size_t i = 0; i < digits.size(); ++i) {
+		unsigned long long current = digits[i] * factor + carry;
+		digits[i] = current % BASE;
+		carry = current / BASE;
 	}
-	if (value_cmp == std::strong_ordering::equal) {
-		*this = BigInt(1);
-		isNegative = (isNegative != other.isNegative);
-		return *this;
+	while (carry != 0) {
+		digits.push_back(carry % BASE);
+		carry /= BASE;
 	}
+	removeLeadingZeros();
+}
 
-	bool result_is_negative = (isNegative != other.isNegative);
-
-	BigInt abs_dividend = *this;
-	abs_dividend.isNegative = false;
-	BigInt abs_divisor = other;
-	abs_divisor.isNegative = false;
-
-	BigInt quotient(0);
-	BigInt current_partial_dividend(0);
-
-	for (long long i = static_cast<long long>(abs_dividend.digits.size()) - 1; i >= 0; --i) {
-		current_partial_dividend *= BigInt(BASE);
-		current_partial_dividend += BigInt(abs_dividend.digits[i]);
-
-		unsigned long long low = 0, high = BigInt::BASE;
-		unsigned long long current_quotient_digit = 0;
-
-		while (low < high) {
-			unsigned long long mid = low + (high - low) / 2;
-
-			BigInt temp_product = abs_divisor;
-			temp_product *= BigInt(mid);
-
-			if (temp_product <= current_partial_dividend) {
-				current_quotient_digit = mid;
-				low = mid + 1;
-			} else {
-				high = mid;
+// Knuth's Algorithm D on magnitudes; the signs of quotient and remainder are left to the caller.
+void BigInt::divModValue(const BigInt& dividend, const BigInt& divisor, BigInt& quotient, BigInt& remainder) {
+	if (dividend.compareValue(divisor) == std::strong_ordering::less) {
+		quotient = BigInt(0);
+		remainder = dividend;
+		remainder.isNegative = false;
+		return;
+	}
+	if (divisor.digits.size() == 1) {
+		quotient = dividend;
+		quotient.isNegative = false;
+		remainder = BigInt(static_cast<long long>(quotient.divSmall(divisor.digits[0])));
+		return;
+	}
+	BIGINT_STATS_ALGORITHM(KnuthDivision, dividend.digits.size());
+	OperationContext::Scope scope;
+
+	unsigned long long norm = BASE / (divisor.digits.back() + 1);
+	BigInt u = dividend;
+	BigInt v = divisor;
+	u.isNegative = false;
+	v.isNegative = false;
+	u.mulSmall(norm);
+	v.mulSmall(norm);
+
+	size_t n = v.digits.size();
+	size_t m = u.digits.size() - n;
+	u.digits.push_back(0);
+
+	Limbs q(m + 1, 0);
+	unsigned long long v_top = v.digits[n - 1];
+	unsigned long long v_next = v.digits[n - 2];
+
+	for (size_t j = m + 1; j-- > 0;) {
+		OperationContext::checkpoint(static_cast<double>(m - j) / static_cast<double>(m + 1));
+		unsigned long long numerator = u.digits[j + n] * BASE + u.digits[j + n - 1];
+		unsigned long long qhat = numerator / v_top;
+		unsigned long long rhat = numerator % v_top;
+		while (qhat >= BASE || qhat * v_next > rhat * BASE + u.digits[j + n - 2]) {
+			--qhat;
+			rhat += v_top;
+			if (rhat >= BASE) {
+				break;
 			}
 		}
 
-		quotient *= BigInt(BASE);
-		quotient += BigInt(current_quotient_digit);
+		unsigned long long carry = Mpn::submul_1(u.digits.data() + j, v.digits.data(), n, qhat);
+		bool borrow = u.digits[j + n] < carry;
+		u.digits[j + n] = u.digits[j + n] + (borrow ? BASE : 0) - carry;
 
-		if (current_quotient_digit > 0) {
-			BigInt to_subtract = abs_divisor;
-			to_subtract *= BigInt(current_quotient_digit);
-			current_partial_dividend -= to_subtract;
+		if (borrow) {
+			--qhat;
+			unsigned long long add_carry = Mpn::add_n(u.digits.data() + j, u.digits.data() + j, v.digits.data(), n);
+			u.digits[j + n] = (u.digits[j + n] + add_carry) % BASE;
 		}
+		q[j] = qhat;
+	}
+
+	quotient.digits = std::move(q);
+	quotient.isNegative = false;
+	quotient.removeLeadingZeros();
+
+	u.digits.resize(n);
+	u.removeLeadingZeros();
+	u.divSmall(norm);
+	remainder = std::move(u);
+}
+
+BigInt& BigInt::operator/=(const BigInt& other) {
+	BIGINT_STATS_OP(Divide);
+	if (other.isNull()) {
+		throw std::runtime_error("Division by zero");
 	}
 
+	bool result_is_negative = (isNegative != other.isNegative);
+	BigInt quotient, remainder;
+	divModValue(*this, other, quotient, remainder);
+
 	digits = std::move(quotient.digits);
 	isNegative = result_is_negative;
 
@@ -341,16 +412,19 @@ BigInt& BigInt::operator/=(const BigInt& other) {
 	return *this;
 }
 BigInt& BigInt::operator%=(const BigInt& other) {
+	BIGINT_STATS_OP(Modulo);
 	if (other.isNull()) {
 		throw std::runtime_error("Modulo by zero");
 	}
 
-	BigInt quotient = *this / other;
-	*this -= (quotient * other);
+	bool result_is_negative = isNegative;
+	BigInt quotient, remainder;
+	divModValue(*this, other, quotient, remainder);
 
-	if (isNull()) {
-		isNegative = false;
-	}
+	digits = std::move(remainder.digits);
+	isNegative = result_is_negative;
+
+	removeLeadingZeros();
 
 	return *this;
 }
@@ -383,6 +457,8 @@ bool BigInt::operator<=(const BigInt& other) const { return !(*this > other); }
 bool BigInt::operator>=(const BigInt& other) const { return !(*this < other); }
 
 std::ostream& operator<<(std::ostream& os, const BigInt& num) {
+	BIGINT_STATS_OP(ToString);
+	OperationContext::Scope scope;
 	if (num.isNull()) {
 		os << '0';
 		return os;
@@ -393,6 +469,9 @@ std::ostream& operator<<(std::ostream& os, const BigInt& num) {
 	}
 	os << num.digits.back();
 	for (long long i = static_cast<long long>(num.digits.size()) - 2; i >= 0; --i) {
+		if (i % 4096 == 0) {
+			OperationContext::checkpoint(1.0 - static_cast<double>(i) / static_cast<double>(num.digits.size()));
+		}
 		os << std::setw(BigInt::BASE_DIGITS) << std::setfill('0') << num.digits[i];
 	}
 
@@ -416,33 +495,17 @@ std::istream& operator>>(std::istream& is, BigInt& num) {
 }
 
 BigInt BigInt::mod_exp(const BigInt& base, const BigInt& exp, const BigInt& mod) {
-	if (mod.isNull() || mod == BigInt(1)) {
-		if (mod.isNull()) {
-			throw std::runtime_error("Modulo by zero");
-		}
+	BIGINT_STATS_OP(ModExp);
+	if (mod.isNull()) {
+		throw std::runtime_error("Modulo by zero");
+	}
+	if (mod == BigInt(1)) {
 		return BigInt(0);
 	}
 	if (exp.isNegative) {
 		throw std::invalid_argument("Negative exp");
 	}
-	if (exp.isNull()) {
-		return BigInt(1);
-	}
-	if (base.isNull()) {
-		return BigInt(0);
-	}
-	BigInt normalized_base = base % mod;
-	if (normalized_base.isNegative) {
-		normalized_base += mod;
-	}
-	BigInt half_exp_result = mod_exp(normalized_base, exp / BigInt(2), mod);
-	BigInt result_squared = (half_exp_result * half_exp_result) % mod;
-	if ((exp % BigInt(2)).isNull()) {
-		return result_squared;
-	} else {
-		BigInt final_result = (normalized_base * result_squared) % mod;
-		return final_result;
-	}
+	return BarrettContext(mod).pow(base, exp);
 }
 
 void BigInt::shiftLeft(const int k) {
@@ -455,69 +518,101 @@ void BigInt::shiftLeft(const int k) {
 	}
 }
 
-BigInt BigInt::karatsubaRecursive(BigInt num1, BigInt num2) {
-	if (num1.isNull() || num2.isNull()) {
-		return BigInt(0);
+static void trimDigits(BigInt::Limbs& digits) {
+	while (digits.size() > 1 && digits.back() == 0) {
+		digits.pop_back();
 	}
+}
 
-	size_t n = 1;
-	size_t maxDigitsSize = std::max(num1.digits.size(), num2.digits.size());
-
-	while (n < maxDigitsSize) {
-		n <<= 1;
+void BigInt::addDigitsAt(Limbs& acc, const Limbs& value, size_t offset) {
+	if (acc.size() < offset + value.size()) {
+		acc.resize(offset + value.size(), 0);
 	}
-
-	num1.digits.resize(n, 0);
-	num2.digits.resize(n, 0);
-
-	if (n == 1) {
-		return num1 * num2;
+	unsigned long long carry = Mpn::add_n(acc.data() + offset, acc.data() + offset, value.data(), value.size());
+	size_t rest = offset + value.size();
+	carry = Mpn::add_1(acc.data() + rest, acc.data() + rest, acc.size() - rest, carry);
+	if (carry != 0) {
+		acc.push_back(carry);
 	}
+}
 
-	BigInt xLow, xHigh, yLow, yHigh;
-	size_t halfN = n / 2;
-
-	xLow.digits.assign(num1.digits.begin(), num1.digits.begin() + halfN);
-	xLow.removeLeadingZeros();
-
-	xHigh.digits.assign(num1.digits.begin() + halfN, num1.digits.end());
-	xHigh.removeLeadingZeros();
-
-	yLow.digits.assign(num2.digits.begin(), num2.digits.begin() + halfN);
-	yLow.removeLeadingZeros();
-
-	yHigh.digits.assign(num2.digits.begin() + halfN, num2.digits.end());
-	yHigh.removeLeadingZeros();
-
-	BigInt prodHighHigh = karatsubaRecursive(xHigh, yHigh);
-	BigInt prodLowLow = karatsubaRecursive(xLow, yLow);
-
-	BigInt sumXHighXLow = xHigh + xLow;
-	BigInt sumYHighYLow = yHigh + yLow;
-	BigInt prodOfSums = karatsubaRecursive(sumXHighXLow, sumYHighYLow);
-
-	BigInt middleTermProduct = prodOfSums;
-	middleTermProduct -= prodHighHigh;
-	middleTermProduct -= prodLowLow;
-
-	prodHighHigh.shiftLeft(static_cast<int>(n));
-	middleTermProduct.shiftLeft(static_cast<int>(halfN));
-
-	BigInt finalProductValue = prodHighHigh;
-	finalProductValue += middleTermProduct;
-	finalProductValue += prodLowLow;
+void BigInt::subtractDigits(Limbs& acc, const Limbs& value) {
+	size_t common = std::min(acc.size(), value.size());
+	unsigned long long borrow = Mpn::sub_n(acc.data(), acc.data(), value.data(), common);
+	Mpn::sub_1(acc.data() + common, acc.data() + common, acc.size() - common, borrow);
+}
 
-	finalProductValue.removeLeadingZeros();
+BigInt::Limbs BigInt::karatsubaDigits(const Limbs& num1, const Limbs& num2) {
+	const Limbs& a = (num1.size() >= num2.size()) ? num1 : num2;
+	const Limbs& b = (num1.size() >= num2.size()) ? num2 : num1;
+	size_t n = a.size();
+	size_t m = b.size();
+
+	if (m < KARATSUBA_THRESHOLD) {
+		return schoolbookDigits(a, b);
+	}
+	BIGINT_STATS_ALGORITHM(Karatsuba, n);
+	OperationContext::Scope scope;
+
+	Limbs result(n + m, 0);
+	if (2 * m <= n) {
+		for (size_t offset = 0; offset < n; offset += m) {
+			OperationContext::checkpoint(static_cast<double>(offset) / static_cast<double>(n));
+			Limbs chunk(a.begin() + offset, a.begin() + std::min(n, offset + m));
+			trimDigits(chunk);
+			addDigitsAt(result, karatsubaDigits(chunk, b), offset);
+		}
+		result.resize(n + m);
+		return result;
+	}
+
+	size_t half = n / 2;
+	Limbs a_low(a.begin(), a.begin() + half);
+	Limbs a_high(a.begin() + half, a.end());
+	Limbs b_low(b.begin(), b.begin() + half);
+	Limbs b_high(b.begin() + half, b.end());
+	trimDigits(a_low);
+	trimDigits(b_low);
+
+	Limbs low_product = karatsubaDigits(a_low, b_low);
+	OperationContext::checkpoint(1.0 / 3);
+	Limbs high_product = karatsubaDigits(a_high, b_high);
+	OperationContext::checkpoint(2.0 / 3);
+
+	addDigitsAt(a_low, a_high, 0);
+	addDigitsAt(b_low, b_high, 0);
+	Limbs middle_product = karatsubaDigits(a_low, b_low);
+	subtractDigits(middle_product, low_product);
+	subtractDigits(middle_product, high_product);
+	trimDigits(middle_product);
+	trimDigits(low_product);
+	trimDigits(high_product);
+
+	addDigitsAt(result, low_product, 0);
+	addDigitsAt(result, middle_product, half);
+	addDigitsAt(result, high_product, 2 * half);
+	result.resize(n + m);
+	return result;
+}
 
-	return finalProductValue;
+BigInt BigInt::schoolbookMultiply(const BigInt& num1, const BigInt& num2) {
+	BIGINT_STATS_OP(Multiply);
+	BigInt ans;
+	ans.digits = schoolbookDigits(num1.digits, num2.digits);
+	ans.isNegative = num1.isNegative != num2.isNegative;
+	ans.removeLeadingZeros();
+	return ans;
 }
 
 BigInt BigInt::karatsuba(const BigInt& num1, const BigInt& num2) {
+	BIGINT_STATS_OP(Multiply);
 	bool sign = false;
 	if (num1.isNegative != num2.isNegative) {
 		sign = true;
 	}
-	BigInt ans = karatsubaRecursive(num1, num2);
+	BigInt ans;
+	ans.digits = karatsubaDigits(num1.digits, num2.digits);
+	ans.removeLeadingZeros();
 	ans.isNegative = sign;
 	if (ans.isNull()) {
 		ans.isNegative = false;
@@ -525,32 +620,56 @@ BigInt BigInt::karatsuba(const BigInt& num1, const BigInt& num2) {
 	return ans;
 }
 
+// Iterative radix-2 transform. Twiddles come from a per-thread table for the largest size seen so far, computed in
+// long double and rounded once, so each is within one ulp of the exact root (the beta of fftErrorBounded).
 void BigInt::fftAlgorithm(std::vector<cd>& a, bool invert) {
-	int n = a.size();
+	size_t n = a.size();
 	if (n == 1) {
 		return;
 	}
 
-	std::vector<cd> a0(n / 2), a1(n / 2);
-	for (int i = 0; 2 * i < n; i++) {
-		a0[i] = a[2 * i];
-		a1[i] = a[2 * i + 1];
+	static thread_local std::vector<cd> roots;
+	if (roots.size() < n / 2) {
+		roots.resize(n / 2);
+		for (size_t k = 0; k < n / 2; ++k) {
+			long double angle = 2 * acosl(-1.0L) * static_cast<long double>(k) / static_cast<long double>(n);
+			roots[k] = cd(static_cast<double>(cosl(angle)), static_cast<double>(sinl(angle)));
+		}
+	}
+	size_t stride = roots.size() / (n / 2);
+
+	for (size_t i = 1, j = 0; i < n; ++i) {
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j) {
+			std::swap(a[i], a[j]);
+		}
 	}
-	fftAlgorithm(a0, invert);
-	fftAlgorithm(a1, invert);
 
-	double ang = 2 * PI / n * (invert ? -1.0 : 1.0);
-	cd w(1.0, 0.0);
-	cd wn(cos(ang), sin(ang));
+	for (size_t len = 2; len <= n; len <<= 1) {
+		OperationContext::checkpoint();
+		size_t step = stride * (n / len);
+		for (size_t i = 0; i < n; i += len) {
+			for (size_t k = 0; k < len / 2; ++k) {
+				cd w = roots[k * step];
+				if (invert) {
+					w = std::conj(w);
+				}
+				cd u = a[i + k];
+				cd v = a[i + k + len / 2] * w;
+				a[i + k] = u + v;
+				a[i + k + len / 2] = u - v;
+			}
+		}
+	}
 
-	for (int i = 0; 2 * i < n; i++) {
-		a[i] = a0[i] + w * a1[i];
-		a[i + n / 2] = a0[i] - w * a1[i];
-		if (invert) {
-			a[i] /= 2.0;
-			a[i + n / 2] /= 2.0;
+	if (invert) {
+		for (cd& x : a) {
+			x /= static_cast<double>(n);
 		}
-		w *= wn;
 	}
 }
 
@@ -559,7 +678,7 @@ void BigInt::fft(BigInt& num, bool invert) {
 
 	if (n_orig == 1) {
 			std::vector<cd> temp_coeffs(1);
-			temp_coeffs[0] = cd(static_cast<long double>(num.digits[0]), 0.0);
+			temp_coeffs[0] = cd(static_cast<double>(num.digits[0]), 0.0);
 			fftAlgorithm(temp_coeffs, invert);
 			if (invert) {
 				num.digits[0] = static_cast<unsigned long long>(std::round(temp_coeffs[0].real()));
@@ -574,7 +693,7 @@ void BigInt::fft(BigInt& num, bool invert) {
 
 	std::vector<cd> coeffs(n, cd(0, 0));
 	for (size_t i = 0; i < n_orig; ++i) {
-		coeffs[i] = cd(static_cast<long double>(num.digits[i]), 0.0);
+		coeffs[i] = cd(static_cast<double>(num.digits[i]), 0.0);
 	}
 
 	fftAlgorithm(coeffs, invert);
@@ -589,69 +708,611 @@ void BigInt::fft(BigInt& num, bool invert) {
 	}
 }
 
+// Limbs are split into FFT_PIECES digits of base FFT_BASE before transforming, so the convolution terms stay small
+// enough to round back exactly. The product is below FFT_BASE^n, so no carry is left after the last piece.
+size_t BigInt::fftSize(size_t limbs1, size_t limbs2) {
+	size_t n = 1;
+	while (n < FFT_PIECES * (limbs1 + limbs2)) {
+		n <<= 1;
+	}
+	return n;
+}
+
+double BigInt::fftNorm(const Limbs& digits) {
+	double sum = 0;
+	for (unsigned long long limb : digits) {
+		for (size_t j = 0; j < FFT_PIECES; ++j) {
+			double piece = static_cast<double>(limb % FFT_BASE);
+			sum += piece * piece;
+			limb /= FFT_BASE;
+		}
+	}
+	return std::sqrt(sum);
+}
+
+// Percival's bound on the error of any coefficient of a length-n cyclic convolution through double precision
+// transforms: ||x|| ||y|| ((1 + eps)^3m (1 + eps sqrt5)^(3m + 1) (1 + beta)^3m - 1), m = log2 n, with eps = beta = 2^-53.
+// The result rounds to the exact integer while the bound stays below 1/2; a quarter leaves room for the bound's own
+// evaluation and for the packed-input split in fftDigits.
+bool BigInt::fftErrorBounded(double norm_product, size_t n) {
+	const double eps = std::ldexp(1.0, -53);
+	double m = std::log2(static_cast<double>(n));
+	double growth = 3 * m * std::log1p(eps) + (3 * m + 1) * std::log1p(eps * std::sqrt(5.0)) + 3 * m * std::log1p(eps);
+	return norm_product * std::expm1(growth) < 0.25;
+}
+
+std::vector<BigInt::cd> BigInt::fftSpectrum(const Limbs& digits, size_t n) {
+	std::vector<cd> spectrum(n, cd(0, 0));
+	for (size_t i = 0; i < digits.size(); ++i) {
+		unsigned long long limb = digits[i];
+		for (size_t j = 0; j < FFT_PIECES; ++j) {
+			spectrum[FFT_PIECES * i + j] = cd(static_cast<double>(limb % FFT_BASE), 0.0);
+			limb /= FFT_BASE;
+		}
+	}
+	fftAlgorithm(spectrum, false);
+	return spectrum;
+}
+
+BigInt::Limbs BigInt::fftInverse(std::vector<cd>& product) {
+	fftAlgorithm(product, true);
+
+	Limbs result(product.size() / FFT_PIECES + 1, 0);
+	unsigned long long carry = 0;
+	unsigned long long scale = 1;
+	for (size_t i = 0; i < product.size(); ++i) {
+		carry += static_cast<unsigned long long>(std::llround(product[i].real()));
+		result[i / FFT_PIECES] += carry % FFT_BASE * scale;
+		carry /= FFT_BASE;
+		scale = (i % FFT_PIECES == FFT_PIECES - 1) ? 1 : scale * FFT_BASE;
+	}
+	trimDigits(result);
+	return result;
+}
+
+// Both operands go through one complex transform as z = x + iy; with Z = FFT(z), X_k = (Z_k + conj Z_-k) / 2 and
+// Y_k = (Z_k - conj Z_-k) / 2i, so X_k Y_k = (Z_k^2 - conj(Z_-k)^2) / 4i. The packed input has norm^2
+// ||x||^2 + ||y||^2 >= 2 ||x|| ||y||, which is what the error bound is charged with.
+bool BigInt::fftDigits(const Limbs& num1, const Limbs& num2, Limbs& result) {
+	size_t n = fftSize(num1.size(), num2.size());
+	double norm1 = fftNorm(num1);
+	double norm2 = fftNorm(num2);
+	if (!fftErrorBounded(norm1 * norm1 + norm2 * norm2, n)) {
+		return false;
+	}
+	BIGINT_STATS_ALGORITHM(Fft, std::max(num1.size(), num2.size()));
+	OperationContext::Scope scope;
+
+	std::vector<cd> z(n, cd(0, 0));
+	for (size_t i = 0; i < num1.size(); ++i) {
+		unsigned long long limb = num1[i];
+		for (size_t j = 0; j < FFT_PIECES; ++j) {
+			z[FFT_PIECES * i + j].real(static_cast<double>(limb % FFT_BASE));
+			limb /= FFT_BASE;
+		}
+	}
+	for (size_t i = 0; i < num2.size(); ++i) {
+		unsigned long long limb = num2[i];
+		for (size_t j = 0; j < FFT_PIECES; ++j) {
+			z[FFT_PIECES * i + j].imag(static_cast<double>(limb % FFT_BASE));
+			limb /= FFT_BASE;
+		}
+	}
+	fftAlgorithm(z, false);
+	OperationContext::checkpoint(0.45);
+
+	std::vector<cd> product(n);
+	for (size_t k = 0; k < n; ++k) {
+		cd zk = z[k];
+		cd zj = std::conj(z[(n - k) & (n - 1)]);
+		product[k] = (zk * zk - zj * zj) * cd(0, -0.25);
+	}
+	OperationContext::checkpoint(0.55);
+	result = fftInverse(product);
+	return true;
+}
+
+// Falls back to Karatsuba when the error bound cannot guarantee the floating point result.
 BigInt BigInt::fftMultiply(const BigInt& num1, const BigInt& num2) {
+	BIGINT_STATS_OP(Multiply);
 	if (num1.isNull() || num2.isNull()) {
 		return BigInt(0);
 	}
+	BigInt result;
+	if (!fftDigits(num1.digits, num2.digits, result.digits)) {
+		result.digits = karatsubaDigits(num1.digits, num2.digits);
+	}
+	result.isNegative = num1.isNegative != num2.isNegative;
+	result.removeLeadingZeros();
+	return result;
+}
 
-	bool resultIsNegative = (num1.isNegative != num2.isNegative);
 
-	std::vector<cd> fa(num1.digits.size());
-	for (size_t i = 0; i < num1.digits.size(); ++i) {
-		fa[i] = cd(static_cast<long double>(num1.digits[i]), 0.0);
+unsigned long long BigInt::toULL() const {
+	unsigned long long value = 0;
+	for (size_t i = digits.size(); i-- > 0;) {
+		value = value * BASE + digits[i];
 	}
+	return value;
+}
 
-	std::vector<cd> fb(num2.digits.size());
-	for (size_t i = 0; i < num2.digits.size(); ++i) {
-		fb[i] = cd(static_cast<long double>(num2.digits[i]), 0.0);
+// False when the magnitude needs more than 128 bits; 10^45 > 2^128, so at most five limbs are read.
+bool BigInt::magnitude128(uint128& magnitude) const {
+	if (digits.size() > 5) {
+		return false;
 	}
+	const uint128 max = ~uint128(0);
+	magnitude = 0;
+	for (size_t i = digits.size(); i-- > 0;) {
+		if (magnitude > (max - digits[i]) / BASE) {
+			return false;
+		}
+		magnitude = magnitude * BASE + digits[i];
+	}
+	return true;
+}
 
-	size_t n = 1;
-	while (n < fa.size() + fb.size()) {
-		n <<= 1;
+long long BigInt::to_int64() const {
+	if (!fits<long long>()) {
+		throw std::out_of_range("BigInt does not fit in int64");
 	}
+	uint128 magnitude = 0;
+	magnitude128(magnitude);
+	unsigned long long low = static_cast<unsigned long long>(magnitude);
+	return static_cast<long long>(isNegative ? 0ULL - low : low);
+}
 
-	fa.resize(n, cd(0, 0));
-	fb.resize(n, cd(0, 0));
+BigInt::int128 BigInt::to_int128() const {
+	if (!fits<int128>()) {
+		throw std::out_of_range("BigInt does not fit in int128");
+	}
+	uint128 magnitude = 0;
+	magnitude128(magnitude);
+	return static_cast<int128>(isNegative ? uint128(0) - magnitude : magnitude);
+}
+
+// Up to four limbs (< 10^36 < 2^120) convert exactly through uint128, which rounds correctly. Beyond that the top four
+// limbs scaled by a tabulated 10^(9 * rest) in long double estimate the value to within 2^-61 relative, well inside half a double
+// ulp (2^-54), so the estimate decides which side of the midpoint between the two neighbouring doubles the value
+// lies on. Only when it lands within 2^-58 of that midpoint is the midpoint built as a BigInt and compared exactly.
+double BigInt::to_double() const {
+	uint128 magnitude = 0;
+	if (digits.size() <= 4) {
+		magnitude128(magnitude);
+		double result = static_cast<double>(magnitude);
+		return isNegative ? -result : result;
+	}
+	size_t rest = digits.size() - 4;
+	if (rest * BASE_DIGITS > 400) {
+		return isNegative ? -HUGE_VAL : HUGE_VAL;
+	}
+	for (size_t i = digits.size(); i-- > rest;) {
+		magnitude = magnitude * BASE + digits[i];
+	}
+	// 10^(9j) correctly rounded to long double (strtold rounds correctly), for every scale that can stay finite.
+	static const std::vector<long double> scales = [] {
+		std::vector<long double> table;
+		for (size_t j = 0; j * BASE_DIGITS <= 400; ++j) {
+			table.push_back(std::strtold(("1e" + std::to_string(j * BASE_DIGITS)).c_str(), nullptr));
+		}
+		return table;
+	}();
+	long double estimate = static_cast<long double>(magnitude) * scales[rest];
+	int exponent = 0;
+	frexpl(estimate, &exponent);
+	long double ulp = ldexpl(1.0L, exponent - 53);
+	long double below = floorl(estimate / ulp) * ulp;
+	long double midpoint = below + ulp / 2;
+	bool up = estimate > midpoint;
+	if (fabsl(estimate - midpoint) <= ldexpl(estimate, -58)) {
+		BigInt exact(static_cast<long long>(ldexpl(midpoint, 54 - exponent)));
+		exact *= pow(BigInt(2), static_cast<unsigned long long>(exponent - 54));
+		std::strong_ordering order = compareValue(exact);
+		up = order == std::strong_ordering::greater ||
+		     (order == std::strong_ordering::equal && fmodl(below / ulp, 2.0L) != 0);
+	}
+	double result = static_cast<double>(up ? below + ulp : below);
+	return isNegative ? -result : result;
+}
+
+BigIntStats BigInt::stats() { return StatsRecorder::current(); }
 
-	fftAlgorithm(fa, false);
-	fftAlgorithm(fb, false);
+void BigInt::reset_stats() { StatsRecorder::current() = BigIntStats{}; }
 
-	for (size_t i = 0; i < n; i++) {
-		fa[i] *= fb[i];
+unsigned long long BigInt::modSmall(unsigned long long divisor) const {
+	unsigned long long rem = 0;
+	for (size_t i = digits.size(); i-- > 0;) {
+		rem = (digits[i] + rem * BASE) % divisor;
 	}
+	return rem;
+}
 
-	fftAlgorithm(fa, true);
+std::vector<uint32_t> BigInt::toBinaryWords() const {
+	std::vector<uint32_t> words;
+	BigInt rest = *this;
+	rest.isNegative = false;
+	while (!rest.isNull()) {
+		words.push_back(static_cast<uint32_t>(rest.divSmall(1ULL << 32)));
+	}
+	return words;
+}
 
-	BigInt result;
-	result.digits.assign(n + 1, 0);
+size_t BigInt::bitLength(const std::vector<uint32_t>& words) {
+	return words.empty() ? 0 : 32 * (words.size() - 1) + (32 - __builtin_clz(words.back()));
+}
 
-	unsigned long long carry = 0;
-	for (size_t i = 0; i < n; i++) {
-		double realVal = fa[i].real();
-		unsigned long long termVal = static_cast<unsigned long long>(std::round(realVal));
+// Up to two limbs the value fits in 64 bits. Beyond that log2 of the top three limbs plus the weight of the rest is
+// accurate to far better than 10^-6, so only a value within that distance of a power of two needs the exact check.
+size_t BigInt::bit_length() const {
+	size_t size = digits.size();
+	if (size <= 2) {
+		unsigned long long value = size == 2 ? digits[1] * BASE + digits[0] : digits[0];
+		return value == 0 ? 0 : 64 - __builtin_clzll(value);
+	}
+	long double lead = (static_cast<long double>(digits[size - 1]) * BASE + digits[size - 2]) * BASE + digits[size - 3];
+	long double estimate = log2l(lead) + static_cast<long double>(size - 3) * log2l(static_cast<long double>(BASE));
+	long double nearest = roundl(estimate);
+	if (fabsl(estimate - nearest) > 1e-6L) {
+		return static_cast<size_t>(floorl(estimate)) + 1;
+	}
+	size_t power = static_cast<size_t>(nearest);
+	return compareValue(powerOfTwo(power)) == std::strong_ordering::less ? power : power + 1;
+}
 
-		unsigned long long currentSum = termVal + carry;
-		result.digits[i] = currentSum % BASE;
-		carry = currentSum / BASE;
+unsigned long long BigInt::binaryGcd(unsigned long long a, unsigned long long b) {
+	if (a == 0) {
+		return b;
+	}
+	if (b == 0) {
+		return a;
 	}
+	int shift = __builtin_ctzll(a | b);
+	a >>= __builtin_ctzll(a);
+	do {
+		b >>= __builtin_ctzll(b);
+		if (a > b) {
+			std::swap(a, b);
+		}
+		b -= a;
+	} while (b != 0);
+	return a << shift;
+}
 
-	size_t currentIdx = n;
-	while (carry > 0) {
-		if (currentIdx >= result.digits.size()) {
-			result.digits.push_back(0);
+// Knuth's Algorithm L: runs Euclid on the two leading limbs of a and b (taken at the same position)
+// and returns the cofactor matrix for as many steps as the truncated values are guaranteed to agree with.
+bool BigInt::lehmerCofactors(const BigInt& a, const BigInt& b, long long& A, long long& B, long long& C,
+                             long long& D) {
+	size_t n = a.digits.size();
+	auto leading = [n](const BigInt& num) {
+		unsigned long long high = (n - 1 < num.digits.size()) ? num.digits[n - 1] : 0;
+		unsigned long long low = (n - 2 < num.digits.size()) ? num.digits[n - 2] : 0;
+		return high * BASE + low;
+	};
+
+	int128 x = leading(a);
+	int128 y = leading(b);
+	int128 a11 = 1, a12 = 0, a21 = 0, a22 = 1;
+	while (y + a21 != 0 && y + a22 != 0) {
+		int128 q = (x + a11) / (y + a21);
+		if (q != (x + a12) / (y + a22)) {
+			break;
+		}
+		int128 t = a11 - q * a21;
+		a11 = a21;
+		a21 = t;
+		t = a12 - q * a22;
+		a12 = a22;
+		a22 = t;
+		t = x - q * y;
+		x = y;
+		y = t;
+	}
+	A = static_cast<long long>(a11);
+	B = static_cast<long long>(a12);
+	C = static_cast<long long>(a21);
+	D = static_cast<long long>(a22);
+	return B != 0;
+}
+
+// x * a + y * b for non-negative a, b whose combination is known to be non-negative, in a single pass.
+BigInt BigInt::linearCombination(long long x, const BigInt& a, long long y, const BigInt& b) {
+	size_t n = std::max(a.digits.size(), b.digits.size());
+	BigInt result;
+	result.digits.assign(n, 0);
+
+	int128 carry = 0;
+	for (size_t i = 0; i < n; ++i) {
+		int128 a_digit = (i < a.digits.size()) ? a.digits[i] : 0;
+		int128 b_digit = (i < b.digits.size()) ? b.digits[i] : 0;
+		int128 current = a_digit * x + b_digit * y + carry;
+		int128 rem = current % static_cast<int128>(BASE);
+		carry = current / static_cast<int128>(BASE);
+		if (rem < 0) {
+			rem += BASE;
+			--carry;
 		}
-		result.digits[currentIdx] = carry % BASE;
+		result.digits[i] = static_cast<unsigned long long>(rem);
+	}
+	while (carry > 0) {
+		result.digits.push_back(static_cast<unsigned long long>(carry % BASE));
 		carry /= BASE;
-		currentIdx++;
 	}
-
-	result.isNegative = resultIsNegative;
 	result.removeLeadingZeros();
+	return result;
+}
+
+BigInt BigInt::gcd(const BigInt& num1, const BigInt& num2) {
+	BIGINT_STATS_OP(Gcd);
+	BigInt a = num1;
+	BigInt b = num2;
+	a.isNegative = false;
+	b.isNegative = false;
+	if (a.compareValue(b) == std::strong_ordering::less) {
+		std::swap(a, b);
+	}
+
+	while (!b.isNull()) {
+		if (a.digits.size() <= 2) {
+			return BigInt(static_cast<long long>(binaryGcd(a.toULL(), b.toULL())));
+		}
+
+		long long A, B, C, D;
+		if (a.digits.size() - b.digits.size() <= 1 && lehmerCofactors(a, b, A, B, C, D)) {
+			BigInt next_a = linearCombination(A, a, B, b);
+			BigInt next_b = linearCombination(C, a, D, b);
+			a = std::move(next_a);
+			b = std::move(next_b);
+		} else {
+			BigInt rem = a % b;
+			a = std::move(b);
+			b = std::move(rem);
+		}
+	}
+	return a;
+}
+
+BigInt BigInt::extended_gcd(const BigInt& num1, const BigInt& num2, BigInt& x, BigInt& y) {
+	BIGINT_STATS_OP(Gcd);
+	BigInt r0 = num1;
+	BigInt r1 = num2;
+	r0.isNegative = false;
+	r1.isNegative = false;
+	bool swapped = false;
+	if (r0.compareValue(r1) == std::strong_ordering::less) {
+		std::swap(r0, r1);
+		swapped = true;
+	}
+	const BigInt first = r0;
+	const BigInt second = r1;
+
+	BigInt s0(1);
+	BigInt s1(0);
+	while (!r1.isNull()) {
+		long long A, B, C, D;
+		if (r0.digits.size() > 2 && r0.digits.size() - r1.digits.size() <= 1 &&
+		    lehmerCofactors(r0, r1, A, B, C, D)) {
+			BigInt next_r0 = linearCombination(A, r0, B, r1);
+			BigInt next_r1 = linearCombination(C, r0, D, r1);
+			BigInt next_s0 = BigInt(A) * s0 + BigInt(B) * s1;
+			BigInt next_s1 = BigInt(C) * s0 + BigInt(D) * s1;
+			r0 = std::move(next_r0);
+			r1 = std::move(next_r1);
+			s0 = std::move(next_s0);
+			s1 = std::move(next_s1);
+		} else {
+			BigInt q = r0 / r1;
+			BigInt next_r1 = r0 - q * r1;
+			BigInt next_s1 = s0 - q * s1;
+			r0 = std::move(r1);
+			r1 = std::move(next_r1);
+			s0 = std::move(s1);
+			s1 = std::move(next_s1);
+		}
+	}
+
+	BigInt t = second.isNull() ? BigInt(0) : (r0 - s0 * first) / second;
+	x = swapped ? t : s0;
+	y = swapped ? s0 : t;
+	if (num1.isNegative && !x.isNull()) {
+		x.isNegative = !x.isNegative;
+	}
+	if (num2.isNegative && !y.isNull()) {
+		y.isNegative = !y.isNegative;
+	}
+	return r0;
+}
 
-	if (result.isNull()) {
-		result.isNegative = false;
+BigInt BigInt::mod_inverse(const BigInt& num, const BigInt& mod) {
+	if (mod.isNull()) {
+		throw std::runtime_error("Modulo by zero");
 	}
+	BigInt abs_mod = mod;
+	abs_mod.isNegative = false;
 
+	BigInt x, y;
+	if (extended_gcd(num, abs_mod, x, y) != BigInt(1)) {
+		throw std::invalid_argument("Inverse does not exist");
+	}
+	x %= abs_mod;
+	if (x.isNegative) {
+		x += abs_mod;
+	}
+	return x;
+}
+
+BigInt BigInt::pow(const BigInt& base, unsigned long long exp) {
+	BigInt result(1);
+	BigInt current = base;
+	while (exp > 0) {
+		if (exp & 1) {
+			result *= current;
+		}
+		exp >>= 1;
+		if (exp > 0) {
+			current *= current;
+		}
+	}
 	return result;
 }
+
+// Integer Newton iteration from above. The starting point comes either from a long double estimate or, for
+// large inputs, from the root of the upper half of the limbs, so only a couple of full-size steps are needed.
+BigInt BigInt::newtonRoot(const BigInt& num, unsigned int k) {
+	size_t limbs = num.digits.size();
+	BigInt x;
+	if (limbs <= 2 * static_cast<size_t>(k)) {
+		long double top = 0;
+		size_t used = std::min<size_t>(limbs, 3);
+		for (size_t i = 0; i < used; ++i) {
+			top = top * BASE + num.digits[limbs - 1 - i];
+		}
+		long double log_value = logl(top) + static_cast<long double>(limbs - used) * logl(BASE);
+		if (log_value / k < logl(2.0L) - 1e-9L) {
+			return BigInt(1);
+		}
+		long double estimate = expl(log_value / k);
+		x = BigInt(static_cast<long long>(estimate * (1 + 1e-15L)) + 2);
+	} else {
+		size_t shift = limbs / (2 * static_cast<size_t>(k));
+		BigInt high;
+		high.digits.assign(num.digits.begin() + shift * k, num.digits.end());
+		x = newtonRoot(high, k) + BigInt(1);
+		x.shiftLeft(static_cast<int>(shift));
+	}
+
+	const BigInt k_big(k);
+	const BigInt k_minus_one(k - 1);
+	while (true) {
+		BigInt y = (x * k_minus_one + num / pow(x, k - 1)) / k_big;
+		if (y >= x) {
+			return x;
+		}
+		x = std::move(y);
+	}
+}
+
+BigInt BigInt::iroot(const BigInt& num, unsigned int k) {
+	BIGINT_STATS_OP(Root);
+	if (k == 0) {
+		throw std::invalid_argument("Zero root degree");
+	}
+	if (num.isNegative) {
+		if (k % 2 == 0) {
+			throw std::invalid_argument("Even root of negative number");
+		}
+		BigInt abs_num = num;
+		abs_num.isNegative = false;
+		BigInt root = iroot(abs_num, k);
+		root.isNegative = !root.isNull();
+		return root;
+	}
+	if (num.isNull() || k == 1) {
+		return num;
+	}
+	return newtonRoot(num, k);
+}
+
+BigInt BigInt::rootrem(const BigInt& num, unsigned int k, BigInt& rem) {
+	BigInt root = iroot(num, k);
+	rem = num - pow(root, k);
+	return root;
+}
+
+BigInt BigInt::isqrt(const BigInt& num) { return iroot(num, 2); }
+
+BigInt BigInt::sqrtrem(const BigInt& num, BigInt& rem) { return rootrem(num, 2, rem); }
+
+BigInt BigInt::product(std::span<const BigInt> values) {
+	if (values.empty()) {
+		return BigInt(1);
+	}
+	if (values.size() == 1) {
+		return values[0];
+	}
+	size_t middle = values.size() / 2;
+	return product(values.first(middle)) * product(values.subspan(middle));
+}
+
+static std::vector<unsigned long> primesUpTo(unsigned long n) {
+	std::vector<bool> composite(n + 1, false);
+	std::vector<unsigned long> primes;
+	for (unsigned long i = 2; i <= n; ++i) {
+		if (composite[i]) {
+			continue;
+		}
+		primes.push_back(i);
+		for (unsigned long long j = static_cast<unsigned long long>(i) * i; j <= n; j += i) {
+			composite[j] = true;
+		}
+	}
+	return primes;
+}
+
+// Packs small factors into words below BASE^2 so the product tree starts from as few leaves as possible.
+static void appendFactor(std::vector<BigInt>& leaves, unsigned long long& word, unsigned long long factor) {
+	const unsigned long long limit = 1000000000000000000ULL;
+	if (word > limit / factor) {
+		leaves.emplace_back(static_cast<long long>(word));
+		word = 1;
+	}
+	word *= factor;
+}
+
+BigInt BigInt::primeSwing(unsigned long n, const std::vector<unsigned long>& primes) {
+	std::vector<BigInt> leaves;
+	unsigned long long word = 1;
+	for (unsigned long p : primes) {
+		if (p > n) {
+			break;
+		}
+		unsigned long long power = 1;
+		for (unsigned long q = n / p; q > 0; q /= p) {
+			if (q & 1) {
+				power *= p;
+			}
+		}
+		if (power > 1) {
+			appendFactor(leaves, word, power);
+		}
+	}
+	leaves.emplace_back(static_cast<long long>(word));
+	return product(leaves);
+}
+
+BigInt BigInt::factorialRecursive(unsigned long n, const std::vector<unsigned long>& primes) {
+	if (n < 2) {
+		return BigInt(1);
+	}
+	BigInt half = factorialRecursive(n / 2, primes);
+	return half * half * primeSwing(n, primes);
+}
+
+BigInt BigInt::factorial(unsigned long n) { return factorialRecursive(n, primesUpTo(n)); }
+
+BigInt BigInt::binomial(unsigned long n, unsigned long k) {
+	if (k > n) {
+		return BigInt(0);
+	}
+	auto legendre = [](unsigned long m, unsigned long p) {
+		unsigned long exponent = 0;
+		for (unsigned long q = m / p; q > 0; q /= p) {
+			exponent += q;
+		}
+		return exponent;
+	};
+
+	std::vector<BigInt> leaves;
+	unsigned long long word = 1;
+	for (unsigned long p : primesUpTo(n)) {
+		unsigned long exponent = legendre(n, p) - legendre(k, p) - legendre(n - k, p);
+		unsigned long long power = 1;
+		for (unsigned long i = 0; i < exponent; ++i) {
+			power *= p;
+		}
+		if (power > 1) {
+			appendFactor(leaves, word, power);
+		}
+	}
+	leaves.emplace_back(static_cast<long long>(word));
+	return product(leaves);
+}
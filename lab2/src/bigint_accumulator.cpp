@@ -0,0 +1,156 @@
+#include "../include/bigint_accumulator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+BigIntAccumulator::BigIntAccumulator() : negative(false), bound(0) {}
+
+BigIntAccumulator::BigIntAccumulator(const BigInt& initial) : BigIntAccumulator() { *this += initial; }
+
+void BigIntAccumulator::reserve(wide growth, size_t size) {
+	if (bound + growth > LANE_LIMIT) {
+		normalize();
+	}
+	bound += growth;
+	if (lanes.size() < size) {
+		lanes.resize(size, 0);
+	}
+}
+
+void BigIntAccumulator::addLimbs(const BigInt::Limbs& digits, bool subtract) {
+	reserve(BigInt::BASE, digits.size());
+	if (subtract != negative) {
+		for (size_t i = 0; i < digits.size(); ++i) {
+			lanes[i] -= digits[i];
+		}
+	} else {
+		for (size_t i = 0; i < digits.size(); ++i) {
+			lanes[i] += digits[i];
+		}
+	}
+}
+
+BigIntAccumulator& BigIntAccumulator::operator+=(const BigInt& value) {
+	addLimbs(value.digits, value.isNegative);
+	return *this;
+}
+
+BigIntAccumulator& BigIntAccumulator::operator-=(const BigInt& value) {
+	addLimbs(value.digits, !value.isNegative);
+	return *this;
+}
+
+// Below the Karatsuba threshold every product limb lands in its lane directly; a column takes at most
+// min(n, m) products below 10^18. Larger operands are multiplied first and their product added.
+void BigIntAccumulator::addProduct(const BigInt& num1, const BigInt& num2, bool subtract) {
+	const BigInt::Limbs& a = num1.digits;
+	const BigInt::Limbs& b = num2.digits;
+	if (std::min(a.size(), b.size()) >= BigInt::KARATSUBA_THRESHOLD) {
+		BigInt product = num1 * num2;
+		addLimbs(product.digits, subtract != product.isNegative);
+		return;
+	}
+	subtract = subtract != (num1.isNegative != num2.isNegative);
+	wide column = static_cast<wide>(std::min(a.size(), b.size())) * BigInt::BASE * BigInt::BASE;
+	reserve(column, a.size() + b.size());
+	bool decrease = subtract != negative;
+	for (size_t i = 0; i < a.size(); ++i) {
+		int128* lane = lanes.data() + i;
+		unsigned long long limb = a[i];
+		if (decrease) {
+			for (size_t j = 0; j < b.size(); ++j) {
+				lane[j] -= limb * b[j];
+			}
+		} else {
+			for (size_t j = 0; j < b.size(); ++j) {
+				lane[j] += limb * b[j];
+			}
+		}
+	}
+}
+
+void BigIntAccumulator::addmul(const BigInt& num1, const BigInt& num2) { addProduct(num1, num2, false); }
+
+void BigIntAccumulator::submul(const BigInt& num1, const BigInt& num2) { addProduct(num1, num2, true); }
+
+void BigIntAccumulator::addmul(const BigInt& num, long long factor) {
+	unsigned long long magnitude = factor < 0 ? 0ULL - static_cast<unsigned long long>(factor) : factor;
+	reserve(static_cast<wide>(magnitude) * BigInt::BASE, num.digits.size());
+	bool decrease = (num.isNegative != (factor < 0)) != negative;
+	for (size_t i = 0; i < num.digits.size(); ++i) {
+		int128 term = static_cast<int128>(static_cast<wide>(num.digits[i]) * magnitude);
+		lanes[i] += decrease ? -term : term;
+	}
+}
+
+// Carries lanes upward with floor division so every lane ends in [0, BASE). A negative final carry means the
+// total is negative: the lanes are negated, the sign flipped, and the pass repeated on the now positive total.
+void BigIntAccumulator::normalize() const {
+	const int128 base = BigInt::BASE;
+	for (int pass = 0; pass < 2; ++pass) {
+		int128 carry = 0;
+		for (int128& lane : lanes) {
+			int128 current = lane + carry;
+			carry = current / base;
+			lane = current % base;
+			if (lane < 0) {
+				lane += base;
+				--carry;
+			}
+		}
+		if (carry >= 0) {
+			while (carry != 0) {
+				lanes.push_back(carry % base);
+				carry /= base;
+			}
+			break;
+		}
+		for (int128& lane : lanes) {
+			lane = -lane;
+		}
+		lanes.push_back(-carry);
+		negative = !negative;
+	}
+	while (!lanes.empty() && lanes.back() == 0) {
+		lanes.pop_back();
+	}
+	if (lanes.empty()) {
+		negative = false;
+	}
+	bound = BigInt::BASE;
+}
+
+BigInt BigIntAccumulator::value() const {
+	normalize();
+	BigInt result;
+	if (!lanes.empty()) {
+		result.digits.assign(lanes.begin(), lanes.end());
+		result.isNegative = negative;
+	}
+	return result;
+}
+
+void BigIntAccumulator::clear() {
+	lanes.clear();
+	negative = false;
+	bound = 0;
+}
+
+BigInt BigIntAccumulator::sum(std::span<const BigInt> values) {
+	BigIntAccumulator acc;
+	for (const BigInt& value : values) {
+		acc += value;
+	}
+	return acc.value();
+}
+
+BigInt BigIntAccumulator::dot(std::span<const BigInt> num1, std::span<const BigInt> num2) {
+	if (num1.size() != num2.size()) {
+		throw std::invalid_argument("BigIntAccumulator::dot: length mismatch");
+	}
+	BigIntAccumulator acc;
+	for (size_t i = 0; i < num1.size(); ++i) {
+		acc.addmul(num1[i], num2[i]);
+	}
+	return acc.value();
+}
@@ -0,0 +1,169 @@
+#include "../include/bigint_array.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+BigInt BigIntView::to_bigint() const {
+	BigInt result;
+	result.digits.assign(digits.begin(), digits.end());
+	result.isNegative = isNegative;
+	result.removeLeadingZeros();
+	return result;
+}
+
+std::strong_ordering BigIntView::compareMagnitude(std::span<const unsigned long long> a,
+                                                  std::span<const unsigned long long> b) {
+	if (a.size() != b.size()) {
+		return a.size() <=> b.size();
+	}
+	for (size_t i = a.size(); i-- > 0;) {
+		if (a[i] != b[i]) {
+			return a[i] <=> b[i];
+		}
+	}
+	return std::strong_ordering::equal;
+}
+
+std::strong_ordering BigIntView::operator<=>(const BigIntView& other) const {
+	if (isNegative != other.isNegative) {
+		return isNegative ? std::strong_ordering::less : std::strong_ordering::greater;
+	}
+	std::strong_ordering order = compareMagnitude(digits, other.digits);
+	return isNegative ? 0 <=> order : order;
+}
+
+bool BigIntView::operator==(const BigIntView& other) const { return (*this <=> other) == std::strong_ordering::equal; }
+
+BigIntArray::BigIntArray() : offsets{0} {}
+
+BigIntArray::BigIntArray(const std::vector<BigInt>& values) : BigIntArray() {
+	size_t limbs = 0;
+	for (const BigInt& value : values) {
+		limbs += value.digits.size();
+	}
+	reserve(values.size(), limbs);
+	for (const BigInt& value : values) {
+		push_back(value);
+	}
+}
+
+void BigIntArray::reserve(size_t count, size_t limbs) {
+	pool.reserve(limbs);
+	offsets.reserve(count + 1);
+	signs.reserve(count);
+}
+
+void BigIntArray::append(std::span<const unsigned long long> limbs, bool negative) {
+	pool.insert(pool.end(), limbs.begin(), limbs.end());
+	offsets.push_back(pool.size());
+	signs.push_back(negative);
+}
+
+void BigIntArray::push_back(const BigInt& value) { append(value.digits, value.isNegative); }
+
+size_t BigIntArray::size() const { return signs.size(); }
+
+size_t BigIntArray::limb_count() const { return pool.size(); }
+
+BigIntView BigIntArray::operator[](size_t index) const {
+	return BigIntView(std::span<const unsigned long long>(pool.data() + offsets[index], offsets[index + 1] - offsets[index]),
+	                  signs[index] != 0);
+}
+
+BigInt BigIntArray::get(size_t index) const {
+	if (index >= size()) {
+		throw std::out_of_range("BigIntArray index out of range");
+	}
+	return (*this)[index].to_bigint();
+}
+
+std::vector<BigInt> BigIntArray::to_vector() const {
+	std::vector<BigInt> values;
+	values.reserve(size());
+	for (size_t i = 0; i < size(); ++i) {
+		values.push_back((*this)[i].to_bigint());
+	}
+	return values;
+}
+
+// Writes a + b straight into the pool: magnitudes are added when the signs agree, otherwise the smaller is
+// subtracted from the larger and the result takes the larger one's sign.
+void BigIntArray::appendSum(BigIntView a, BigIntView b) {
+	const unsigned long long BASE = BigInt::BASE;
+	std::strong_ordering order = BigIntView::compareMagnitude(a.digits, b.digits);
+	if (a.isNegative != b.isNegative && order == std::strong_ordering::equal) {
+		pool.push_back(0);
+		offsets.push_back(pool.size());
+		signs.push_back(false);
+		return;
+	}
+	std::span<const unsigned long long> big = (order == std::strong_ordering::less) ? b.digits : a.digits;
+	std::span<const unsigned long long> small = (order == std::strong_ordering::less) ? a.digits : b.digits;
+	bool negative = (order == std::strong_ordering::less) ? b.isNegative : a.isNegative;
+
+	size_t start = pool.size();
+	pool.resize(start + big.size() + 1);
+	unsigned long long* out = pool.data() + start;
+	if (a.isNegative == b.isNegative) {
+		unsigned long long carry = 0;
+		for (size_t i = 0; i < big.size(); ++i) {
+			unsigned long long sum = big[i] + (i < small.size() ? small[i] : 0) + carry;
+			carry = sum >= BASE;
+			out[i] = carry ? sum - BASE : sum;
+		}
+		out[big.size()] = carry;
+	} else {
+		unsigned long long borrow = 0;
+		for (size_t i = 0; i < big.size(); ++i) {
+			unsigned long long subtrahend = (i < small.size() ? small[i] : 0) + borrow;
+			borrow = big[i] < subtrahend;
+			out[i] = big[i] + (borrow ? BASE : 0) - subtrahend;
+		}
+		out[big.size()] = 0;
+	}
+	while (pool.size() > start + 1 && pool.back() == 0) {
+		pool.pop_back();
+	}
+	offsets.push_back(pool.size());
+	signs.push_back(negative);
+}
+
+BigIntArray BigIntArray::add(const BigIntArray& num1, const BigIntArray& num2) {
+	if (num1.size() != num2.size()) {
+		throw std::invalid_argument("BigIntArray sizes differ");
+	}
+	BigIntArray result;
+	result.reserve(num1.size(), std::max(num1.limb_count(), num2.limb_count()) + num1.size());
+	for (size_t i = 0; i < num1.size(); ++i) {
+		result.appendSum(num1[i], num2[i]);
+	}
+	return result;
+}
+
+std::vector<int> BigIntArray::compare(const BigIntArray& num1, const BigIntArray& num2) {
+	if (num1.size() != num2.size()) {
+		throw std::invalid_argument("BigIntArray sizes differ");
+	}
+	std::vector<int> result(num1.size());
+	for (size_t i = 0; i < num1.size(); ++i) {
+		std::strong_ordering order = num1[i] <=> num2[i];
+		result[i] = (order == std::strong_ordering::less) ? -1 : (order == std::strong_ordering::greater ? 1 : 0);
+	}
+	return result;
+}
+
+// Sorts a permutation against the views, then gathers the pool once in the new order.
+void BigIntArray::sort() {
+	std::vector<size_t> order(size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return (*this)[a] < (*this)[b]; });
+
+	BigIntArray sorted;
+	sorted.reserve(size(), limb_count());
+	for (size_t index : order) {
+		BigIntView view = (*this)[index];
+		sorted.append(view.limbs(), view.negative());
+	}
+	*this = std::move(sorted);
+}
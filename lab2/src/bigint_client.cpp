@@ -0,0 +1,114 @@
+#include "../include/bigint_client.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+BigIntClient::BigIntClient(const std::string& path) {
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+		throw std::invalid_argument("BigIntClient: socket path is empty or too long");
+	}
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+	fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		throw std::system_error(errno, std::generic_category(), "BigIntClient: socket");
+	}
+	if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+		int error = errno;
+		::close(fd);
+		throw std::system_error(error, std::generic_category(), "BigIntClient: connect " + path);
+	}
+}
+
+BigIntClient::~BigIntClient() { ::close(fd); }
+
+// At most WINDOW requests are outstanding, so neither side can fill its socket buffer while the other is blocked
+// writing; within the window requests go out in one send.
+std::vector<BigIntClient::Result> BigIntClient::execute(const std::vector<Call>& calls) {
+	uint32_t first = nextId;
+	nextId += static_cast<uint32_t>(calls.size());
+	std::vector<Result> results(calls.size());
+	std::string frames;
+	std::string payload;
+	size_t sent = 0;
+	for (size_t received = 0; received < calls.size(); ++received) {
+		if (sent == received) {
+			frames.clear();
+			for (; sent < calls.size() && sent - received < WINDOW; ++sent) {
+				BigIntProtocol::encode(BigIntProtocol::Request{first + static_cast<uint32_t>(sent), calls[sent].op,
+				                                               calls[sent].args},
+				                       frames);
+			}
+			BigIntProtocol::write_all(fd, frames);
+		}
+		if (!BigIntProtocol::read_frame(fd, payload)) {
+			throw std::runtime_error("BigIntClient: server closed the connection");
+		}
+		BigIntProtocol::Response response = BigIntProtocol::decode_response(payload);
+		size_t slot = response.id - first;
+		if (slot >= sent) {
+			throw std::runtime_error("BigIntClient: response for unknown request " + std::to_string(response.id));
+		}
+		Result& result = results[slot];
+		result.ok = response.status != BigIntProtocol::Error;
+		result.value = std::move(response.value);
+		result.error = std::move(response.text);
+		result.latency_ns = response.latency_ns;
+	}
+	return results;
+}
+
+BigIntProtocol::Response BigIntClient::roundTrip(BigIntProtocol::Op op, std::vector<BigInt> args) {
+	std::string frame;
+	BigIntProtocol::encode(BigIntProtocol::Request{nextId++, op, std::move(args)}, frame);
+	BigIntProtocol::write_all(fd, frame);
+	std::string payload;
+	if (!BigIntProtocol::read_frame(fd, payload)) {
+		throw std::runtime_error("BigIntClient: server closed the connection");
+	}
+	BigIntProtocol::Response response = BigIntProtocol::decode_response(payload);
+	lastLatency = response.latency_ns;
+	if (response.status == BigIntProtocol::Error) {
+		throw std::runtime_error(response.text);
+	}
+	return response;
+}
+
+BigInt BigIntClient::call(BigIntProtocol::Op op, std::vector<BigInt> args) {
+	return roundTrip(op, std::move(args)).value;
+}
+
+BigInt BigIntClient::add(const BigInt& num1, const BigInt& num2) { return call(BigIntProtocol::Add, {num1, num2}); }
+
+BigInt BigIntClient::sub(const BigInt& num1, const BigInt& num2) {
+	return call(BigIntProtocol::Subtract, {num1, num2});
+}
+
+BigInt BigIntClient::mul(const BigInt& num1, const BigInt& num2) {
+	return call(BigIntProtocol::Multiply, {num1, num2});
+}
+
+BigInt BigIntClient::div(const BigInt& num1, const BigInt& num2) { return call(BigIntProtocol::Divide, {num1, num2}); }
+
+BigInt BigIntClient::mod(const BigInt& num1, const BigInt& num2) { return call(BigIntProtocol::Modulo, {num1, num2}); }
+
+BigInt BigIntClient::gcd(const BigInt& num1, const BigInt& num2) { return call(BigIntProtocol::Gcd, {num1, num2}); }
+
+BigInt BigIntClient::mod_mul(const BigInt& num1, const BigInt& num2, const BigInt& mod) {
+	return call(BigIntProtocol::ModMul, {num1, num2, mod});
+}
+
+BigInt BigIntClient::mod_exp(const BigInt& base, const BigInt& exp, const BigInt& mod) {
+	return call(BigIntProtocol::ModExp, {base, exp, mod});
+}
+
+std::string BigIntClient::stats() { return roundTrip(BigIntProtocol::Stats, {}).text; }
+
+uint64_t BigIntClient::last_latency_ns() const { return lastLatency; }
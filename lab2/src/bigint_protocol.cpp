@@ -0,0 +1,262 @@
+#include "../include/bigint_protocol.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+static void putU32(std::string& out, uint32_t value) {
+	for (int i = 0; i < 4; ++i) {
+		out.push_back(static_cast<char>(value >> (8 * i)));
+	}
+}
+
+static void putU64(std::string& out, uint64_t value) {
+	for (int i = 0; i < 8; ++i) {
+		out.push_back(static_cast<char>(value >> (8 * i)));
+	}
+}
+
+// Sequential reader over a payload; every read is bounds-checked.
+class BigIntProtocol::Reader {
+   public:
+	explicit Reader(std::string_view data) : data(data) {}
+
+	uint8_t u8() { return static_cast<uint8_t>(take(1)[0]); }
+
+	uint32_t u32() {
+		std::string_view bytes = take(4);
+		uint32_t value = 0;
+		for (int i = 0; i < 4; ++i) {
+			value |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[i])) << (8 * i);
+		}
+		return value;
+	}
+
+	uint64_t u64() {
+		uint64_t low = u32();
+		return low | static_cast<uint64_t>(u32()) << 32;
+	}
+
+	std::string_view take(size_t count) {
+		if (count > data.size() - pos) {
+			throw std::invalid_argument("BigInt protocol: truncated payload");
+		}
+		std::string_view bytes = data.substr(pos, count);
+		pos += count;
+		return bytes;
+	}
+
+	void finish() const {
+		if (pos != data.size()) {
+			throw std::invalid_argument("BigInt protocol: trailing bytes in payload");
+		}
+	}
+
+   private:
+	std::string_view data;
+	size_t pos = 0;
+};
+
+static void putBigInt(std::string& out, const BigInt::Limbs& digits, bool negative) {
+	out.push_back(negative ? 1 : 0);
+	putU32(out, static_cast<uint32_t>(digits.size()));
+	for (unsigned long long limb : digits) {
+		putU32(out, static_cast<uint32_t>(limb));
+	}
+}
+
+static void putString(std::string& out, const std::string& text) {
+	putU32(out, static_cast<uint32_t>(text.size()));
+	out += text;
+}
+
+// The frame length is patched in once the payload is written.
+static size_t beginFrame(std::string& out) {
+	size_t start = out.size();
+	putU32(out, 0);
+	return start;
+}
+
+static void endFrame(std::string& out, size_t start) {
+	uint32_t length = static_cast<uint32_t>(out.size() - start - 4);
+	for (int i = 0; i < 4; ++i) {
+		out[start + i] = static_cast<char>(length >> (8 * i));
+	}
+}
+
+const char* BigIntProtocol::op_name(Op op) {
+	switch (op) {
+		case Add:
+			return "add";
+		case Subtract:
+			return "sub";
+		case Multiply:
+			return "mul";
+		case Divide:
+			return "div";
+		case Modulo:
+			return "mod";
+		case Gcd:
+			return "gcd";
+		case ModMul:
+			return "modmul";
+		case ModExp:
+			return "modexp";
+		case Stats:
+			return "stats";
+		default:
+			return "unknown";
+	}
+}
+
+size_t BigIntProtocol::arity(Op op) {
+	switch (op) {
+		case ModMul:
+		case ModExp:
+			return 3;
+		case Stats:
+			return 0;
+		default:
+			return 2;
+	}
+}
+
+BigInt BigIntProtocol::readBigInt(Reader& reader) {
+	BigInt value;
+	bool negative = reader.u8() != 0;
+	uint32_t count = reader.u32();
+	if (count == 0) {
+		throw std::invalid_argument("BigInt protocol: empty limb vector");
+	}
+	std::string_view bytes = reader.take(static_cast<size_t>(count) * 4);
+	value.digits.resize(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		uint32_t limb = 0;
+		for (int b = 0; b < 4; ++b) {
+			limb |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[4 * i + b])) << (8 * b);
+		}
+		if (limb >= BigInt::BASE) {
+			throw std::invalid_argument("BigInt protocol: limb out of range");
+		}
+		value.digits[i] = limb;
+	}
+	value.isNegative = negative;
+	value.removeLeadingZeros();
+	return value;
+}
+
+void BigIntProtocol::encode(const Request& request, std::string& out) {
+	size_t start = beginFrame(out);
+	putU32(out, request.id);
+	out.push_back(static_cast<char>(request.op));
+	out.push_back(static_cast<char>(request.args.size()));
+	for (const BigInt& arg : request.args) {
+		putBigInt(out, arg.digits, arg.isNegative);
+	}
+	endFrame(out, start);
+}
+
+void BigIntProtocol::encode(const Response& response, std::string& out) {
+	size_t start = beginFrame(out);
+	putU32(out, response.id);
+	out.push_back(static_cast<char>(response.status));
+	putU64(out, response.latency_ns);
+	if (response.status == Ok) {
+		putBigInt(out, response.value.digits, response.value.isNegative);
+	} else {
+		putString(out, response.text);
+	}
+	endFrame(out, start);
+}
+
+BigIntProtocol::Request BigIntProtocol::decode_request(std::string_view payload) {
+	Reader reader(payload);
+	Request request;
+	request.id = reader.u32();
+	uint8_t op = reader.u8();
+	if (op == 0 || op >= OpCount) {
+		throw std::invalid_argument("BigInt protocol: unknown op " + std::to_string(op));
+	}
+	request.op = static_cast<Op>(op);
+	uint8_t argc = reader.u8();
+	for (uint8_t i = 0; i < argc; ++i) {
+		request.args.push_back(readBigInt(reader));
+	}
+	reader.finish();
+	return request;
+}
+
+BigIntProtocol::Response BigIntProtocol::decode_response(std::string_view payload) {
+	Reader reader(payload);
+	Response response;
+	response.id = reader.u32();
+	uint8_t status = reader.u8();
+	if (status > Text) {
+		throw std::invalid_argument("BigInt protocol: unknown status " + std::to_string(status));
+	}
+	response.status = static_cast<Status>(status);
+	response.latency_ns = reader.u64();
+	if (response.status == Ok) {
+		response.value = readBigInt(reader);
+	} else {
+		response.text = std::string(reader.take(reader.u32()));
+	}
+	reader.finish();
+	return response;
+}
+
+// Reads exactly size bytes; returns the number read before a clean end of stream.
+static size_t readFully(int fd, char* buffer, size_t size) {
+	size_t done = 0;
+	while (done < size) {
+		ssize_t got = ::read(fd, buffer + done, size - done);
+		if (got == 0) {
+			break;
+		}
+		if (got < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::system_error(errno, std::generic_category(), "BigInt protocol: read");
+		}
+		done += static_cast<size_t>(got);
+	}
+	return done;
+}
+
+bool BigIntProtocol::read_frame(int fd, std::string& payload) {
+	char header[4];
+	size_t got = readFully(fd, header, 4);
+	if (got == 0) {
+		return false;
+	}
+	if (got < 4) {
+		throw std::runtime_error("BigInt protocol: truncated frame header");
+	}
+	uint32_t length = Reader(std::string_view(header, 4)).u32();
+	if (length > MAX_FRAME) {
+		throw std::runtime_error("BigInt protocol: frame of " + std::to_string(length) + " bytes exceeds the limit");
+	}
+	payload.resize(length);
+	if (readFully(fd, payload.data(), length) != length) {
+		throw std::runtime_error("BigInt protocol: truncated frame");
+	}
+	return true;
+}
+
+void BigIntProtocol::write_all(int fd, std::string_view data) {
+	while (!data.empty()) {
+		ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::system_error(errno, std::generic_category(), "BigInt protocol: write");
+		}
+		data.remove_prefix(static_cast<size_t>(sent));
+	}
+}
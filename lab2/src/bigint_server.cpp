@@ -0,0 +1,375 @@
+#include "../include/bigint_server.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+struct BigIntServer::Connection {
+	explicit Connection(int fd) : fd(fd) {}
+	~Connection() { ::close(fd); }
+
+	int fd;
+	std::mutex writeMutex;
+	bool broken = false;
+};
+
+BigIntServer::BigIntServer(Options options) : options(std::move(options)) {
+	if (this->options.threads == 0) {
+		this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	this->options.batch = std::max<size_t>(1, this->options.batch);
+	this->options.contexts = std::max<size_t>(1, this->options.contexts);
+	this->options.queue_limit = std::max(this->options.queue_limit, this->options.batch);
+}
+
+BigIntServer::~BigIntServer() { stop(); }
+
+// A socket file left behind by a server that died is removed: connecting to it is refused. Anything else at the
+// path, a live server's socket included, is left alone and reported.
+static void removeStaleSocket(const std::string& path, const sockaddr_un& address) {
+	struct stat existing;
+	if (::lstat(path.c_str(), &existing) != 0) {
+		if (errno == ENOENT) {
+			return;
+		}
+		throw std::system_error(errno, std::generic_category(), "BigIntServer: stat " + path);
+	}
+	if (!S_ISSOCK(existing.st_mode)) {
+		throw std::system_error(EEXIST, std::generic_category(), "BigIntServer: not a socket " + path);
+	}
+	int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (probe < 0) {
+		throw std::system_error(errno, std::generic_category(), "BigIntServer: socket");
+	}
+	int result = ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+	int error = result == 0 ? EADDRINUSE : errno;
+	::close(probe);
+	if (error != ECONNREFUSED) {
+		throw std::system_error(error, std::generic_category(), "BigIntServer: socket in use " + path);
+	}
+	::unlink(path.c_str());
+}
+
+void BigIntServer::start() {
+	if (running) {
+		return;
+	}
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (options.path.empty() || options.path.size() >= sizeof(address.sun_path)) {
+		throw std::invalid_argument("BigIntServer: socket path is empty or too long");
+	}
+	std::memcpy(address.sun_path, options.path.c_str(), options.path.size() + 1);
+
+	removeStaleSocket(options.path, address);
+	listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listener < 0) {
+		throw std::system_error(errno, std::generic_category(), "BigIntServer: socket");
+	}
+	struct stat bound;
+	if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(listener, 64) < 0 ||
+	    ::lstat(options.path.c_str(), &bound) != 0) {
+		int error = errno;
+		::close(listener);
+		listener = -1;
+		throw std::system_error(error, std::generic_category(), "BigIntServer: bind " + options.path);
+	}
+	socketDevice = bound.st_dev;
+	socketInode = bound.st_ino;
+
+	stopping = false;
+	running = true;
+	for (unsigned int i = 0; i < options.threads; ++i) {
+		workers.emplace_back([this] { workLoop(); });
+	}
+	acceptor = std::thread([this] { acceptLoop(); });
+}
+
+// Shutting the sockets down wakes the acceptor and every reader blocked in read; the workers drain and exit.
+void BigIntServer::stop() {
+	if (!running) {
+		return;
+	}
+	running = false;
+	::shutdown(listener, SHUT_RDWR);
+	acceptor.join();
+	::close(listener);
+	listener = -1;
+	struct stat current;
+	if (::lstat(options.path.c_str(), &current) == 0 && S_ISSOCK(current.st_mode) && current.st_dev == socketDevice &&
+	    current.st_ino == socketInode) {
+		::unlink(options.path.c_str());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(connectionsMutex);
+		for (const std::weak_ptr<Connection>& weak : connections) {
+			if (std::shared_ptr<Connection> connection = weak.lock()) {
+				::shutdown(connection->fd, SHUT_RDWR);
+			}
+		}
+	}
+	for (auto& reader : readers) {
+		reader.first.join();
+	}
+	readers.clear();
+	connections.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	queueReady.notify_all();
+	queueSpace.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	queue.clear();
+}
+
+void BigIntServer::acceptLoop() {
+	while (true) {
+		int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			return;
+		}
+		auto connection = std::make_shared<Connection>(fd);
+		std::lock_guard<std::mutex> lock(connectionsMutex);
+		connections.erase(std::remove_if(connections.begin(), connections.end(),
+		                                 [](const std::weak_ptr<Connection>& weak) { return weak.expired(); }),
+		                  connections.end());
+		connections.push_back(connection);
+		for (auto reader = readers.begin(); reader != readers.end();) {
+			if (reader->second->load()) {
+				reader->first.join();
+				reader = readers.erase(reader);
+			} else {
+				++reader;
+			}
+		}
+		auto finished = std::make_shared<std::atomic<bool>>(false);
+		readers.emplace_back(std::thread([this, connection, finished] {
+			                     readLoop(connection);
+			                     finished->store(true);
+		                     }),
+		                     finished);
+	}
+}
+
+// A malformed frame gets an error response when its id can still be read; a broken stream ends the connection.
+void BigIntServer::readLoop(std::shared_ptr<Connection> connection) {
+	std::string payload;
+	try {
+		while (BigIntProtocol::read_frame(connection->fd, payload)) {
+			Pending pending{connection, {}, std::chrono::steady_clock::now()};
+			try {
+				pending.request = BigIntProtocol::decode_request(payload);
+			} catch (const std::invalid_argument& e) {
+				BigIntProtocol::Response response;
+				response.status = BigIntProtocol::Error;
+				response.text = e.what();
+				for (size_t i = 0; i < 4 && i < payload.size(); ++i) {
+					response.id |= static_cast<uint32_t>(static_cast<unsigned char>(payload[i])) << (8 * i);
+				}
+				std::string frame;
+				BigIntProtocol::encode(response, frame);
+				std::lock_guard<std::mutex> lock(connection->writeMutex);
+				BigIntProtocol::write_all(connection->fd, frame);
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueSpace.wait(lock, [this] { return stopping || queue.size() < options.queue_limit; });
+			if (stopping) {
+				return;
+			}
+			queue.push_back(std::move(pending));
+			lock.unlock();
+			queueReady.notify_one();
+		}
+	} catch (const std::exception&) {
+		// The peer vanished or sent garbage framing; dropping the connection is all that can be done.
+	}
+}
+
+void BigIntServer::workLoop() {
+	std::vector<Pending> batch;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+			if (stopping) {
+				return;
+			}
+			size_t take = std::min(options.batch, queue.size());
+			for (size_t i = 0; i < take; ++i) {
+				batch.push_back(std::move(queue.front()));
+				queue.pop_front();
+			}
+		}
+		queueSpace.notify_all();
+
+		// Responses are gathered per connection so a batch costs one send per client rather than one per request.
+		std::vector<std::pair<std::shared_ptr<Connection>, std::string>> outgoing;
+		for (Pending& pending : batch) {
+			BigIntProtocol::Response response = evaluate(pending.request);
+			response.latency_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			                                                std::chrono::steady_clock::now() - pending.received)
+			                                                .count());
+			record(pending.request.op, response.status == BigIntProtocol::Error, response.latency_ns);
+			auto slot = std::find_if(outgoing.begin(), outgoing.end(),
+			                         [&](const auto& entry) { return entry.first == pending.connection; });
+			if (slot == outgoing.end()) {
+				outgoing.emplace_back(pending.connection, std::string());
+				slot = outgoing.end() - 1;
+			}
+			BigIntProtocol::encode(response, slot->second);
+		}
+		batch.clear();
+
+		for (auto& [connection, frames] : outgoing) {
+			std::lock_guard<std::mutex> lock(connection->writeMutex);
+			if (connection->broken) {
+				continue;
+			}
+			try {
+				BigIntProtocol::write_all(connection->fd, frames);
+			} catch (const std::exception&) {
+				connection->broken = true;
+				::shutdown(connection->fd, SHUT_RDWR);
+			}
+		}
+	}
+}
+
+BigIntProtocol::Response BigIntServer::evaluate(const BigIntProtocol::Request& request) {
+	BigIntProtocol::Response response;
+	response.id = request.id;
+	try {
+		const std::vector<BigInt>& args = request.args;
+		if (args.size() != BigIntProtocol::arity(request.op)) {
+			throw std::invalid_argument(std::string(BigIntProtocol::op_name(request.op)) + " takes " +
+			                            std::to_string(BigIntProtocol::arity(request.op)) + " arguments");
+		}
+		switch (request.op) {
+			case BigIntProtocol::Add:
+				response.value = args[0] + args[1];
+				break;
+			case BigIntProtocol::Subtract:
+				response.value = args[0] - args[1];
+				break;
+			case BigIntProtocol::Multiply:
+				response.value = args[0] * args[1];
+				break;
+			case BigIntProtocol::Divide:
+				response.value = args[0] / args[1];
+				break;
+			case BigIntProtocol::Modulo:
+				response.value = args[0] % args[1];
+				break;
+			case BigIntProtocol::Gcd:
+				response.value = BigInt::gcd(args[0], args[1]);
+				break;
+			case BigIntProtocol::ModMul:
+				response.value = context(args[2])->mul(args[0], args[1]);
+				break;
+			case BigIntProtocol::ModExp:
+				response.value = context(args[2])->pow(args[0], args[1]);
+				break;
+			case BigIntProtocol::Stats:
+				response.status = BigIntProtocol::Text;
+				response.text = stats();
+				break;
+			default:
+				throw std::invalid_argument("unsupported op");
+		}
+	} catch (const std::exception& e) {
+		response.status = BigIntProtocol::Error;
+		response.value = BigInt();
+		response.text = e.what();
+	}
+	return response;
+}
+
+// The precomputation for a new modulus runs outside the lock so that lookups for other moduli are not held up by it.
+// Two workers missing on the same modulus may both build it; the second to finish adopts the first one's context.
+std::shared_ptr<const BarrettContext> BigIntServer::context(const BigInt& modulus) {
+	std::ostringstream text;
+	text << modulus;
+	const std::string key = text.str();
+	auto cached = [this, &key]() -> std::shared_ptr<const BarrettContext> {
+		auto found = contextIndex.find(key);
+		if (found == contextIndex.end()) {
+			return nullptr;
+		}
+		contextOrder.splice(contextOrder.begin(), contextOrder, found->second);
+		return found->second->second;
+	};
+	{
+		std::lock_guard<std::mutex> lock(contextMutex);
+		if (auto hit = cached()) {
+			return hit;
+		}
+	}
+	auto created = std::make_shared<const BarrettContext>(modulus);
+	std::lock_guard<std::mutex> lock(contextMutex);
+	if (auto hit = cached()) {
+		return hit;
+	}
+	contextOrder.emplace_front(key, created);
+	contextIndex[key] = contextOrder.begin();
+	if (contextOrder.size() > options.contexts) {
+		contextIndex.erase(contextOrder.back().first);
+		contextOrder.pop_back();
+	}
+	return created;
+}
+
+void BigIntServer::record(BigIntProtocol::Op op, bool failed, uint64_t latency_ns) {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	OpStats& entry = opStats[op];
+	++entry.count;
+	entry.errors += failed;
+	entry.total_ns += latency_ns;
+	++entry.latency[BigIntStats::bucket(latency_ns, BigIntStats::LATENCY_BUCKETS)];
+}
+
+// Percentiles are read off the power-of-two latency buckets, so each is reported as the bucket's upper bound.
+std::string BigIntServer::stats() const {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	std::ostringstream out;
+	for (size_t op = 1; op < BigIntProtocol::OpCount; ++op) {
+		const OpStats& entry = opStats[op];
+		if (entry.count == 0) {
+			continue;
+		}
+		auto percentile = [&entry](double fraction) {
+			uint64_t target = static_cast<uint64_t>(fraction * static_cast<double>(entry.count - 1)) + 1;
+			uint64_t seen = 0;
+			for (size_t b = 0; b < entry.latency.size(); ++b) {
+				seen += entry.latency[b];
+				if (seen >= target) {
+					return static_cast<double>(uint64_t(2) << b) / 1000.0;
+				}
+			}
+			return 0.0;
+		};
+		out << std::left << std::setw(8) << BigIntProtocol::op_name(static_cast<BigIntProtocol::Op>(op))
+		    << " count=" << entry.count << " errors=" << entry.errors << std::fixed << std::setprecision(1)
+		    << " mean_us=" << static_cast<double>(entry.total_ns) / static_cast<double>(entry.count) / 1000.0
+		    << " p50_us<=" << percentile(0.5) << " p99_us<=" << percentile(0.99) << "\n";
+	}
+	return out.str();
+}
@@ -0,0 +1,50 @@
+#include "../include/bigint_stats.hpp"
+
+#include <bit>
+
+const char* BigIntStats::operation_name(Operation op) {
+	static const char* const names[] = {"add",    "subtract", "multiply",  "divide",     "modulo",
+	                                    "modexp", "gcd",      "root",      "to_string",  "from_string"};
+	return (op >= 0 && op < OperationCount) ? names[op] : "unknown";
+}
+
+const char* BigIntStats::algorithm_name(Algorithm algorithm) {
+	static const char* const names[] = {"schoolbook", "karatsuba", "fft", "knuth_division", "barrett_reduce"};
+	return (algorithm >= 0 && algorithm < AlgorithmCount) ? names[algorithm] : "unknown";
+}
+
+size_t BigIntStats::bucket(uint64_t value, size_t buckets) {
+	size_t index = value == 0 ? 0 : static_cast<size_t>(std::bit_width(value)) - 1;
+	return std::min(index, buckets - 1);
+}
+
+BigIntStats& StatsRecorder::current() {
+	thread_local BigIntStats stats;
+	return stats;
+}
+
+void StatsRecorder::allocation(size_t bytes) {
+	BigIntStats& stats = current();
+	++stats.allocations;
+	stats.allocatedBytes += bytes;
+}
+
+void StatsRecorder::algorithm(BigIntStats::Algorithm algorithm, size_t limbs) {
+	++current().algorithmCalls[algorithm][BigIntStats::bucket(limbs, BigIntStats::SIZE_BUCKETS)];
+}
+
+StatsRecorder::Scope::Scope(BigIntStats::Operation op) : op(op) {
+	uint64_t calls = ++current().calls[op];
+	sampled = calls % BigIntStats::LATENCY_SAMPLE_PERIOD == 1;
+	if (sampled) {
+		start = std::chrono::steady_clock::now();
+	}
+}
+
+StatsRecorder::Scope::~Scope() {
+	if (sampled) {
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		++current().latency[op][BigIntStats::bucket(ns, BigIntStats::LATENCY_BUCKETS)];
+	}
+}
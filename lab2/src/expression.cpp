@@ -0,0 +1,185 @@
+#include "../include/expression.hpp"
+
+#include <cctype>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Recursive descent over the grammar in expression.hpp; depth is capped so hostile nesting cannot exhaust the stack.
+class ExpressionParser {
+   public:
+	ExpressionParser(std::string_view text, size_t max_bits) : text(text), maxBits(max_bits) {}
+
+	BigInt parse() {
+		BigInt value = expr();
+		skipSpace();
+		if (pos != text.size()) {
+			fail("unexpected '" + std::string(1, text[pos]) + "'");
+		}
+		return value;
+	}
+
+   private:
+	std::string_view text;
+	size_t maxBits;
+	size_t pos = 0;
+	size_t depth = 0;
+
+	inline static const size_t MAX_DEPTH = 256;
+
+	[[noreturn]] void fail(const std::string& message) const {
+		throw std::invalid_argument(message + " at position " + std::to_string(pos));
+	}
+
+	void skipSpace() {
+		while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+			++pos;
+		}
+	}
+
+	bool accept(char c) {
+		skipSpace();
+		if (pos < text.size() && text[pos] == c) {
+			++pos;
+			return true;
+		}
+		return false;
+	}
+
+	void expect(char c) {
+		if (!accept(c)) {
+			fail(std::string("expected '") + c + "'");
+		}
+	}
+
+	struct Nesting {
+		explicit Nesting(ExpressionParser& parser) : parser(parser) {
+			if (++parser.depth > MAX_DEPTH) {
+				parser.fail("expression nested too deeply");
+			}
+		}
+		~Nesting() { --parser.depth; }
+		ExpressionParser& parser;
+	};
+
+	BigInt expr() {
+		BigInt value = term();
+		while (true) {
+			if (accept('+')) {
+				value += term();
+			} else if (accept('-')) {
+				value -= term();
+			} else {
+				break;
+			}
+		}
+		return value;
+	}
+
+	BigInt term() {
+		BigInt value = unary();
+		while (true) {
+			if (accept('*')) {
+				value *= unary();
+			} else if (accept('/')) {
+				value /= unary();
+			} else if (accept('%')) {
+				value %= unary();
+			} else {
+				break;
+			}
+		}
+		return value;
+	}
+
+	BigInt unary() {
+		Nesting nesting(*this);
+		if (accept('-')) {
+			return BigInt(0) - unary();
+		}
+		if (accept('+')) {
+			return unary();
+		}
+		BigInt base = primary();
+		if (accept('^')) {
+			return power(base, unary());
+		}
+		return base;
+	}
+
+	BigInt primary() {
+		skipSpace();
+		if (pos == text.size()) {
+			fail("unexpected end of expression");
+		}
+		if (accept('(')) {
+			BigInt value = expr();
+			expect(')');
+			return value;
+		}
+		size_t start = pos;
+		if (std::isdigit(static_cast<unsigned char>(text[pos]))) {
+			while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+				++pos;
+			}
+			return BigInt(std::string(text.substr(start, pos - start)));
+		}
+		while (pos < text.size() && std::isalpha(static_cast<unsigned char>(text[pos]))) {
+			++pos;
+		}
+		if (start == pos) {
+			fail("unexpected '" + std::string(1, text[pos]) + "'");
+		}
+		std::string name(text.substr(start, pos - start));
+		std::vector<BigInt> args;
+		expect('(');
+		do {
+			args.push_back(expr());
+		} while (accept(','));
+		expect(')');
+		return call(name, args);
+	}
+
+	BigInt call(const std::string& name, const std::vector<BigInt>& args) {
+		size_t arity = name == "modexp" ? 3 : 2;
+		if (name != "pow" && name != "modexp" && name != "gcd") {
+			fail("unknown function '" + name + "'");
+		}
+		if (args.size() != arity) {
+			fail(name + " takes " + std::to_string(arity) + " arguments");
+		}
+		if (name == "pow") {
+			return power(args[0], args[1]);
+		}
+		if (name == "gcd") {
+			return BigInt::gcd(args[0], args[1]);
+		}
+		if (args[1] < BigInt(0)) {
+			fail("modexp with a negative exponent");
+		}
+		return BigInt::mod_exp(args[0], args[1], args[2]);
+	}
+
+	BigInt power(const BigInt& base, const BigInt& exp) {
+		if (exp < BigInt(0)) {
+			fail("negative exponent");
+		}
+		size_t base_bits = base.bit_length();
+		if (base_bits <= 1 || exp == BigInt(0)) {
+			bool odd = exp % BigInt(2) != BigInt(0);
+			return BigInt::pow(base, odd ? 1 : (exp == BigInt(0) ? 0 : 2));
+		}
+		if (!exp.fits<unsigned long long>()) {
+			throw std::length_error("power result exceeds " + std::to_string(maxBits) + " bits");
+		}
+		unsigned long long e = static_cast<unsigned long long>(exp.to_int128());
+		if (e > maxBits / base_bits) {
+			throw std::length_error("power result exceeds " + std::to_string(maxBits) + " bits");
+		}
+		return BigInt::pow(base, e);
+	}
+};
+
+BigInt Expression::evaluate(std::string_view text, size_t max_bits) {
+	return ExpressionParser(text, max_bits).parse();
+}
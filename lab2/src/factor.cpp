@@ -0,0 +1,580 @@
+#include "../include/factor.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using wide = BigInt::uint128;
+
+using Element = std::vector<uint64_t>;
+
+// out = a * b / R mod n by coarsely integrated operand scanning (CIOS), for a, b < n < R = 2^(64k). K > 0 fixes the
+// word count at compile time so the loops unroll and t lives in registers or on the stack; K = 0 takes it at run
+// time and works in the caller's scratch row of k + 2 words. out may alias a or b.
+template <size_t K>
+static void montgomeryMul(uint64_t* out, const uint64_t* a, const uint64_t* b, const uint64_t* n,
+                          uint64_t neg_inverse, size_t runtime_k, uint64_t* scratch) {
+	const size_t k = K != 0 ? K : runtime_k;
+	uint64_t local[K + 2] = {};
+	uint64_t* t = K != 0 ? local : scratch;
+	if (K == 0) {
+		std::fill(t, t + k + 2, 0);
+	}
+	for (size_t i = 0; i < k; ++i) {
+		wide carry = 0;
+		for (size_t j = 0; j < k; ++j) {
+			carry += static_cast<wide>(a[j]) * b[i] + t[j];
+			t[j] = static_cast<uint64_t>(carry);
+			carry >>= 64;
+		}
+		carry += t[k];
+		t[k] = static_cast<uint64_t>(carry);
+		t[k + 1] = static_cast<uint64_t>(carry >> 64);
+
+		uint64_t m = t[0] * neg_inverse;
+		carry = (static_cast<wide>(m) * n[0] + t[0]) >> 64;
+		for (size_t j = 1; j < k; ++j) {
+			carry += static_cast<wide>(m) * n[j] + t[j];
+			t[j - 1] = static_cast<uint64_t>(carry);
+			carry >>= 64;
+		}
+		carry += t[k];
+		t[k - 1] = static_cast<uint64_t>(carry);
+		t[k] = t[k + 1] + static_cast<uint64_t>(carry >> 64);
+	}
+	// t < 2n: one conditional subtraction, done when t overflowed k words or t >= n.
+	bool subtract = t[k] != 0;
+	if (!subtract) {
+		subtract = true;
+		for (size_t i = k; i-- > 0;) {
+			if (t[i] != n[i]) {
+				subtract = t[i] > n[i];
+				break;
+			}
+		}
+	}
+	uint64_t borrow = 0;
+	for (size_t i = 0; i < k; ++i) {
+		wide diff = static_cast<wide>(t[i]) - (subtract ? n[i] : 0) - borrow;
+		out[i] = static_cast<uint64_t>(diff);
+		borrow = static_cast<uint64_t>(diff >> 64) & 1;
+	}
+}
+
+// Arithmetic modulo an odd n > 1 held in k 64-bit words, in Montgomery form with R = 2^(64k); every element stays
+// fully reduced below n. Output arguments may alias inputs. The scratch row makes an instance single-threaded.
+class Factorizer::Field {
+   public:
+	explicit Field(const BigInt& modulus) : k((modulus.bit_length() + 63) / 64), scratch(k + 2) {
+		n = toWords(modulus, k);
+		BigInt r = BigInt::pow(BigInt(2), 64 * k) % modulus;
+		unit = toWords(r, k);
+		r2 = toWords(r * r % modulus, k);
+		// Newton's iteration doubles the correct low bits of n^-1 mod 2^64 per step; n itself is right to 3 bits.
+		uint64_t inverse = n[0];
+		for (int i = 0; i < 5; ++i) {
+			inverse *= 2 - n[0] * inverse;
+		}
+		negInverse = 0 - inverse;
+		static constexpr Kernel fixed[] = {montgomeryMul<0>, montgomeryMul<1>, montgomeryMul<2>,
+		                                   montgomeryMul<3>, montgomeryMul<4>, montgomeryMul<5>,
+		                                   montgomeryMul<6>, montgomeryMul<7>, montgomeryMul<8>};
+		kernel = k < std::size(fixed) ? fixed[k] : montgomeryMul<0>;
+	}
+
+	size_t size() const { return k; }
+	const Element& one() const { return unit; }
+
+	void mul(Element& out, const Element& a, const Element& b) const {
+		kernel(out.data(), a.data(), b.data(), n.data(), negInverse, k, scratch.data());
+	}
+
+	void sqr(Element& out, const Element& a) const { mul(out, a, a); }
+
+	void add(Element& out, const Element& a, const Element& b) const {
+		uint64_t carry = 0;
+		for (size_t i = 0; i < k; ++i) {
+			wide sum = static_cast<wide>(a[i]) + b[i] + carry;
+			out[i] = static_cast<uint64_t>(sum);
+			carry = static_cast<uint64_t>(sum >> 64);
+		}
+		if (carry != 0 || !below(out.data(), n.data())) {
+			subtractModulus(out.data());
+		}
+	}
+
+	void sub(Element& out, const Element& a, const Element& b) const {
+		uint64_t borrow = 0;
+		for (size_t i = 0; i < k; ++i) {
+			wide diff = static_cast<wide>(a[i]) - b[i] - borrow;
+			out[i] = static_cast<uint64_t>(diff);
+			borrow = static_cast<uint64_t>(diff >> 64) & 1;
+		}
+		if (borrow != 0) {
+			uint64_t carry = 0;
+			for (size_t i = 0; i < k; ++i) {
+				wide sum = static_cast<wide>(out[i]) + n[i] + carry;
+				out[i] = static_cast<uint64_t>(sum);
+				carry = static_cast<uint64_t>(sum >> 64);
+			}
+		}
+	}
+
+	// A residue in [0, n) into Montgomery form. Leaving the form is never needed: R is a unit mod n, so an element
+	// has the same gcd with n as the residue it stands for.
+	Element from(const BigInt& value) const {
+		Element out(k);
+		mul(out, toWords(value, k), r2);
+		return out;
+	}
+
+   private:
+	size_t k;
+	Element n;
+	Element unit;
+	Element r2;
+	uint64_t negInverse;
+	mutable Element scratch;
+	using Kernel = void (*)(uint64_t*, const uint64_t*, const uint64_t*, const uint64_t*, uint64_t, size_t, uint64_t*);
+	Kernel kernel;
+
+	bool below(const uint64_t* a, const uint64_t* b) const {
+		for (size_t i = k; i-- > 0;) {
+			if (a[i] != b[i]) {
+				return a[i] < b[i];
+			}
+		}
+		return false;
+	}
+
+	void subtractModulus(uint64_t* a) const {
+		uint64_t borrow = 0;
+		for (size_t i = 0; i < k; ++i) {
+			wide diff = static_cast<wide>(a[i]) - n[i] - borrow;
+			a[i] = static_cast<uint64_t>(diff);
+			borrow = static_cast<uint64_t>(diff >> 64) & 1;
+		}
+	}
+};
+
+std::vector<uint64_t> Factorizer::toWords(const BigInt& value, size_t count) {
+	std::vector<uint32_t> halves = value.toBinaryWords();
+	std::vector<uint64_t> words(count, 0);
+	for (size_t i = 0; i < halves.size(); ++i) {
+		words[i / 2] |= static_cast<uint64_t>(halves[i]) << (32 * (i % 2));
+	}
+	return words;
+}
+
+BigInt Factorizer::fromWords(const std::vector<uint64_t>& words) {
+	BigInt result;
+	for (size_t i = words.size(); i-- > 0;) {
+		for (int half = 1; half >= 0; --half) {
+			result.mulSmall(1ULL << 32);
+			result += BigInt(static_cast<long long>((words[i] >> (32 * half)) & 0xffffffffULL));
+		}
+	}
+	return result;
+}
+
+// is_prime[i] for i <= limit, by the sieve of Eratosthenes.
+static std::vector<bool> primeTable(uint64_t limit) {
+	std::vector<bool> is_prime(limit + 1, true);
+	is_prime[0] = false;
+	if (limit >= 1) {
+		is_prime[1] = false;
+	}
+	for (uint64_t i = 2; i * i <= limit; ++i) {
+		if (is_prime[i]) {
+			for (uint64_t j = i * i; j <= limit; j += i) {
+				is_prime[j] = false;
+			}
+		}
+	}
+	return is_prime;
+}
+
+static std::vector<uint32_t> primesUpTo(uint64_t limit) {
+	std::vector<bool> is_prime = primeTable(limit);
+	std::vector<uint32_t> primes;
+	for (uint64_t i = 2; i <= limit; ++i) {
+		if (is_prime[i]) {
+			primes.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	return primes;
+}
+
+bool Factorizer::pollard_rho(const BigInt& n, BigInt& factor, uint64_t iterations, uint64_t seed) {
+	if (n < BigInt(4)) {
+		return false;
+	}
+	if (n.digits[0] % 2 == 0) {
+		factor = BigInt(2);
+		return true;
+	}
+	Field field(n);
+	size_t k = field.size();
+	std::mt19937_64 engine(seed);
+	Element x(k), y(k), ys(k), q(k), c(k), diff(k);
+	auto step = [&](Element& value) {
+		field.sqr(value, value);
+		field.add(value, value, c);
+	};
+
+	// Brent: y runs ahead in doubling strides r; products of m differences share one gcd, and a block whose gcd
+	// reaches n is replayed one difference at a time from its saved start ys.
+	const uint64_t m = 128;
+	uint64_t used = 0;
+	while (used < iterations) {
+		c = field.from(BigInt(1) + BigInt::random_below(n - BigInt(1), engine));
+		y = field.from(BigInt::random_below(n, engine));
+		q = field.one();
+		BigInt g(1);
+		for (uint64_t r = 1; g == BigInt(1) && used < iterations; r *= 2) {
+			x = y;
+			for (uint64_t i = 0; i < r; ++i) {
+				step(y);
+			}
+			used += r;
+			for (uint64_t done = 0; done < r && g == BigInt(1); done += m) {
+				ys = y;
+				uint64_t block = std::min(m, r - done);
+				for (uint64_t i = 0; i < block; ++i) {
+					step(y);
+					field.sub(diff, x, y);
+					field.mul(q, q, diff);
+				}
+				used += block;
+				g = BigInt::gcd(fromWords(q), n);
+			}
+		}
+		if (g == n) {
+			g = BigInt(1);
+			for (uint64_t i = 0; i < m && g == BigInt(1); ++i) {
+				step(ys);
+				field.sub(diff, x, ys);
+				g = BigInt::gcd(fromWords(diff), n);
+			}
+		}
+		if (g != BigInt(1) && g != n) {
+			factor = g;
+			return true;
+		}
+	}
+	return false;
+}
+
+// x-only arithmetic on the Montgomery curve B y^2 = x^3 + A x^2 + x in projective (X : Z) coordinates, with
+// a24 = (A + 2) / 4. Temporaries live in the object, so one curve serves one thread.
+class Factorizer::Curve {
+   public:
+	struct Point {
+		Element x;
+		Element z;
+	};
+
+	Curve(const Field& field, Element a24)
+	    : field(field), a24(std::move(a24)), t1(field.size()), t2(field.size()), t3(field.size()),
+	      t4(field.size()) {}
+
+	Point point() const { return Point{Element(field.size()), Element(field.size())}; }
+
+	// out = 2p: X = (X+Z)^2 (X-Z)^2, Z = 4XZ ((X-Z)^2 + a24 * 4XZ).
+	void dbl(Point& out, const Point& p) {
+		field.add(t1, p.x, p.z);
+		field.sqr(t1, t1);
+		field.sub(t2, p.x, p.z);
+		field.sqr(t2, t2);
+		field.sub(t3, t1, t2);
+		field.mul(out.x, t1, t2);
+		field.mul(t4, a24, t3);
+		field.add(t4, t4, t2);
+		field.mul(out.z, t3, t4);
+	}
+
+	// out = p + q given diff = p - q.
+	void add(Point& out, const Point& p, const Point& q, const Point& diff) {
+		field.sub(t1, p.x, p.z);
+		field.add(t2, q.x, q.z);
+		field.mul(t1, t1, t2);
+		field.add(t3, p.x, p.z);
+		field.sub(t4, q.x, q.z);
+		field.mul(t3, t3, t4);
+		field.add(t2, t1, t3);
+		field.sub(t4, t1, t3);
+		field.sqr(t2, t2);
+		field.sqr(t4, t4);
+		field.mul(t1, diff.z, t2);
+		field.mul(out.z, diff.x, t4);
+		out.x = t1;
+	}
+
+	// p = scalar * p by the Montgomery ladder; scalar >= 1.
+	void multiply(Point& p, uint64_t scalar) {
+		if (scalar == 1) {
+			return;
+		}
+		Point low = p;
+		Point high = point();
+		dbl(high, p);
+		for (int bit = 62 - __builtin_clzll(scalar); bit >= 0; --bit) {
+			if ((scalar >> bit) & 1) {
+				add(low, low, high, p);
+				dbl(high, high);
+			} else {
+				add(high, low, high, p);
+				dbl(low, low);
+			}
+		}
+		p = std::move(low);
+	}
+
+   private:
+	const Field& field;
+	Element a24;
+	Element t1, t2, t3, t4;
+};
+
+static BigInt reduce(const BigInt& value, const BigInt& n) {
+	BigInt r = value % n;
+	return r < BigInt(0) ? r + n : r;
+}
+
+// One curve from Suyama's parametrization for sigma. Stage 1 multiplies the starting point by every prime power up
+// to b1. Stage 2 covers each prime p in (b1, 100 * b1] as p = mD +- j, with baby steps [j]Q for j < D/2 coprime to D
+// and giant steps [mD]Q, accumulating X_m Z_j - X_j Z_m into one product that gets a single gcd at the end.
+bool Factorizer::ecmCurve(const BigInt& n, uint64_t sigma, uint64_t b1, const std::vector<uint32_t>& primes,
+                          const std::vector<bool>& stage2_primes, const std::atomic<uint64_t>& best, uint64_t curve,
+                          BigInt& factor) {
+	auto found = [&](const BigInt& g) {
+		if (g != BigInt(1) && g != n) {
+			factor = g;
+			return true;
+		}
+		return false;
+	};
+	auto cancelled = [&] { return best.load(std::memory_order_relaxed) < curve; };
+
+	BigInt s(static_cast<long long>(sigma));
+	BigInt u = reduce(s * s - BigInt(5), n);
+	BigInt v = reduce(BigInt(4) * s, n);
+	BigInt u3 = u * u * u % n;
+	BigInt denominator = reduce(BigInt(16) * u3 * v, n);
+	BigInt g = BigInt::gcd(denominator, n);
+	if (g != BigInt(1)) {
+		return found(g);
+	}
+	BigInt vu = reduce(v - u, n);
+	BigInt numerator = vu * vu % n * vu % n * reduce(BigInt(3) * u + v, n) % n;
+	BigInt a24 = numerator * BigInt::mod_inverse(denominator, n) % n;
+
+	Field field(n);
+	size_t k = field.size();
+	Curve ec(field, field.from(a24));
+	Curve::Point q{field.from(u3), field.from(v * v * v % n)};
+
+	for (uint32_t p : primes) {
+		if (p > b1) {
+			break;
+		}
+		uint64_t power = p;
+		while (power <= b1 / p) {
+			power *= p;
+		}
+		ec.multiply(q, power);
+		if (cancelled()) {
+			return false;
+		}
+	}
+	g = BigInt::gcd(fromWords(q.z), n);
+	if (g != BigInt(1)) {
+		return found(g);
+	}
+
+	const uint64_t d = ECM_D;
+	const uint64_t b2 = 100 * b1;
+	// [j]Q for odd j: [3]Q = [2]Q + Q, then [j + 2]Q = [j]Q + [2]Q with difference [j - 2]Q.
+	std::vector<uint64_t> offsets;
+	std::vector<Curve::Point> baby;
+	Curve::Point q2 = ec.point();
+	ec.dbl(q2, q);
+	Curve::Point previous = q;
+	Curve::Point current = q;
+	for (uint64_t j = 1; j < d / 2; j += 2) {
+		if (std::gcd(j, d) == 1) {
+			offsets.push_back(j);
+			baby.push_back(current);
+		}
+		Curve::Point next = ec.point();
+		if (j == 1) {
+			ec.add(next, q2, q, q);
+		} else {
+			ec.add(next, current, q2, previous);
+		}
+		previous = std::move(current);
+		current = std::move(next);
+	}
+
+	uint64_t m = std::max<uint64_t>(1, b1 / d);
+	Curve::Point giant = q;
+	ec.multiply(giant, d);
+	Curve::Point low = q;
+	ec.multiply(low, m * d);
+	Curve::Point high = q;
+	ec.multiply(high, (m + 1) * d);
+	Element product = field.one();
+	Element left(k), right(k);
+	for (; m * d <= b2 + d / 2; ++m) {
+		for (size_t i = 0; i < offsets.size(); ++i) {
+			uint64_t below = m * d - offsets[i];
+			uint64_t above = m * d + offsets[i];
+			bool hit = (below > b1 && below <= b2 && stage2_primes[below]) ||
+			           (above > b1 && above <= b2 && stage2_primes[above]);
+			if (hit) {
+				field.mul(left, low.x, baby[i].z);
+				field.mul(right, baby[i].x, low.z);
+				field.sub(left, left, right);
+				field.mul(product, product, left);
+			}
+		}
+		Curve::Point next = ec.point();
+		ec.add(next, high, giant, low);
+		low = std::move(high);
+		high = std::move(next);
+		if (cancelled()) {
+			return false;
+		}
+	}
+	return found(BigInt::gcd(fromWords(product), n));
+}
+
+bool Factorizer::ecm(const BigInt& n, BigInt& factor, uint64_t b1, unsigned int curves, unsigned int threads,
+                     uint64_t seed) {
+	if (n < BigInt(4)) {
+		return false;
+	}
+	if (n.digits[0] % 2 == 0) {
+		factor = BigInt(2);
+		return true;
+	}
+	b1 = std::max(b1, ECM_D / 2);
+	const std::vector<uint32_t> primes = primesUpTo(b1);
+	const std::vector<bool> stage2_primes = primeTable(100 * b1);
+
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threads = std::min(threads, std::max(1u, curves));
+	std::atomic<uint64_t> next{0};
+	std::atomic<uint64_t> best{std::numeric_limits<uint64_t>::max()};
+	std::mutex resultMutex;
+	BigInt result;
+	auto work = [&] {
+		while (true) {
+			uint64_t curve = next.fetch_add(1);
+			if (curve >= curves || curve > best.load()) {
+				return;
+			}
+			// Sigma depends only on the seed and the curve number, never on which thread runs it.
+			std::mt19937_64 engine(seed * 0x9e3779b97f4a7c15ULL + curve);
+			uint64_t sigma = 6 + engine() % (uint64_t(1) << 62);
+			BigInt candidate;
+			if (ecmCurve(n, sigma, b1, primes, stage2_primes, best, curve, candidate)) {
+				std::lock_guard<std::mutex> lock(resultMutex);
+				if (curve < best.load()) {
+					best.store(curve);
+					result = candidate;
+				}
+			}
+		}
+	};
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threads; ++i) {
+		workers.emplace_back(work);
+	}
+	work();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	if (best.load() == std::numeric_limits<uint64_t>::max()) {
+		return false;
+	}
+	factor = result;
+	return true;
+}
+
+std::vector<BigInt> Factorizer::factor(const BigInt& n) { return factor(n, Options()); }
+
+// Pushes e copies of the root when m is a perfect e-th power for some 2 <= e <= max_exponent.
+static bool splitPower(const BigInt& m, size_t max_exponent, std::vector<BigInt>& pending) {
+	for (unsigned int e = 2; e <= max_exponent; ++e) {
+		BigInt root = BigInt::iroot(m, e);
+		if (BigInt::pow(root, e) == m) {
+			pending.insert(pending.end(), e, root);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Stage 1 bounds and curve counts for factors of roughly 15, 20, 25, 30 and 35 digits.
+static const std::pair<uint64_t, unsigned int> ECM_SCHEDULE[] = {
+    {2000, 25}, {11000, 90}, {50000, 300}, {250000, 700}, {1000000, 1800}};
+
+std::vector<BigInt> Factorizer::factor(const BigInt& n, const Options& options) {
+	if (n < BigInt(1)) {
+		throw std::invalid_argument("Factorizer: n must be positive");
+	}
+	std::vector<BigInt> result;
+	BigInt rest = n;
+	const uint64_t trial_limit = std::max<uint64_t>(options.trial_limit, 2);
+	for (uint32_t p : primesUpTo(trial_limit)) {
+		if (BigInt(static_cast<long long>(p) * p) > rest) {
+			break;
+		}
+		while (rest.modSmall(p) == 0) {
+			rest.divSmall(p);
+			result.push_back(BigInt(static_cast<long long>(p)));
+		}
+	}
+
+	// Everything left has only prime factors above trial_limit, so it is prime below trial_limit^2 and a perfect
+	// power rest = root^e has e below log2(rest) / log2(trial_limit).
+	const BigInt limit(static_cast<long long>(trial_limit));
+	const BigInt known_prime = limit * limit;
+	const size_t limit_bits = std::max<size_t>(1, limit.bit_length() - 1);
+	std::vector<BigInt> pending;
+	if (rest != BigInt(1)) {
+		pending.push_back(rest);
+	}
+	while (!pending.empty()) {
+		BigInt m = std::move(pending.back());
+		pending.pop_back();
+		if (m < known_prime || BigInt::is_probable_prime(m)) {
+			result.push_back(m);
+			continue;
+		}
+		if (splitPower(m, m.bit_length() / limit_bits, pending)) {
+			continue;
+		}
+		BigInt d;
+		bool split = pollard_rho(m, d, options.rho_iterations, options.seed);
+		for (size_t level = 0; !split && level < std::size(ECM_SCHEDULE); ++level) {
+			split = ecm(m, d, ECM_SCHEDULE[level].first, ECM_SCHEDULE[level].second, options.threads,
+			            options.seed + level);
+		}
+		if (!split) {
+			throw std::runtime_error("Factorizer: no factor found for a composite of " +
+			                         std::to_string(m.bit_length()) + " bits");
+		}
+		pending.push_back(m / d);
+		pending.push_back(d);
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
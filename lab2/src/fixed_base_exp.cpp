@@ -0,0 +1,90 @@
+#include "../include/fixed_base_exp.hpp"
+
+#include <algorithm>
+#include <thread>
+
+// table[i][j] holds base^(j * 2^(window * i)), so an exponent costs one multiplication per window and no squarings.
+FixedBaseExp::FixedBaseExp(const BigInt& base, const BigInt& mod, size_t max_exp_bits, unsigned int window)
+    : ctx(mod), base(ctx.reduce(base)), window(window), maxBits(max_exp_bits) {
+	if (this->window == 0) {
+		this->window = maxBits >= 1024 ? 6 : (maxBits >= 256 ? 5 : 4);
+	}
+	if (this->window > 16) {
+		throw std::invalid_argument("Window is too wide");
+	}
+
+	size_t rows = (maxBits + this->window - 1) / this->window;
+	size_t columns = size_t(1) << this->window;
+	table.resize(rows);
+	BigInt row_base = this->base;
+	for (size_t i = 0; i < rows; ++i) {
+		table[i].resize(columns);
+		table[i][0] = ctx.reduce(BigInt(1));
+		table[i][1] = row_base;
+		for (size_t j = 2; j < columns; ++j) {
+			table[i][j] = ctx.mul(table[i][j - 1], row_base);
+		}
+		row_base = ctx.mul(table[i][columns - 1], row_base);
+	}
+}
+
+const BigInt& FixedBaseExp::modulus() const { return ctx.modulus(); }
+
+size_t FixedBaseExp::max_exp_bits() const { return maxBits; }
+
+BigInt FixedBaseExp::pow(const BigInt& exp) const {
+	if (exp.isNegative) {
+		throw std::invalid_argument("Negative exp");
+	}
+	size_t bits = exp.bit_length();
+	if (bits > maxBits) {
+		return ctx.pow(base, exp);
+	}
+
+	std::vector<uint32_t> words = exp.toBinaryWords();
+	BigInt result = ctx.reduce(BigInt(1));
+	for (size_t row = 0; row * window < bits; ++row) {
+		size_t digit = 0;
+		for (unsigned int t = 0; t < window; ++t) {
+			size_t i = row * window + t;
+			if (i < bits && ((words[i / 32] >> (i % 32)) & 1)) {
+				digit |= size_t(1) << t;
+			}
+		}
+		if (digit != 0) {
+			result = ctx.mul(result, table[row][digit]);
+		}
+	}
+	return result;
+}
+
+std::vector<BigInt> FixedBaseExp::pow_batch(const std::vector<BigInt>& exps, unsigned int threads) const {
+	for (const BigInt& exp : exps) {
+		if (exp.isNegative) {
+			throw std::invalid_argument("Negative exp");
+		}
+	}
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threads = static_cast<unsigned int>(std::min<size_t>(threads, std::max<size_t>(exps.size(), 1)));
+
+	std::vector<BigInt> results(exps.size());
+	auto worker = [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			results[i] = pow(exps[i]);
+		}
+	};
+
+	size_t chunk = (exps.size() + threads - 1) / threads;
+	std::vector<std::thread> pool;
+	for (unsigned int t = 1; t < threads; ++t) {
+		size_t begin = std::min(exps.size(), t * chunk);
+		pool.emplace_back(worker, begin, std::min(exps.size(), begin + chunk));
+	}
+	worker(0, std::min(exps.size(), chunk));
+	for (std::thread& thread : pool) {
+		thread.join();
+	}
+	return results;
+}
@@ -0,0 +1,306 @@
+#include "../include/mpn.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+using limb = Mpn::limb;
+
+// The kernels are written once as always-inline bodies and instantiated twice below: as a plain function and
+// inside a target("bmi2") function, where the constant divisions by BASE compile to MULX/SHRX. Limbs stay below
+// 2^30, so r[i] + a[i] * b + carry fits a 64-bit word and each step needs a single division by BASE.
+#define MPN_INLINE inline __attribute__((always_inline))
+
+static MPN_INLINE limb addBody(limb* r, const limb* a, const limb* b, size_t n) {
+	limb carry = 0;
+	for (size_t i = 0; i < n; ++i) {
+		limb sum = a[i] + b[i] + carry;
+		carry = sum >= Mpn::BASE;
+		r[i] = sum - (carry ? Mpn::BASE : 0);
+	}
+	return carry;
+}
+
+static MPN_INLINE limb subBody(limb* r, const limb* a, const limb* b, size_t n) {
+	limb borrow = 0;
+	for (size_t i = 0; i < n; ++i) {
+		limb subtrahend = b[i] + borrow;
+		borrow = a[i] < subtrahend;
+		r[i] = a[i] + (borrow ? Mpn::BASE : 0) - subtrahend;
+	}
+	return borrow;
+}
+
+static MPN_INLINE limb add1Body(limb* r, const limb* a, size_t n, limb carry) {
+	size_t i = 0;
+	for (; i < n && carry != 0; ++i) {
+		limb sum = a[i] + carry;
+		carry = sum / Mpn::BASE;
+		r[i] = sum % Mpn::BASE;
+	}
+	if (r != a) {
+		for (; i < n; ++i) {
+			r[i] = a[i];
+		}
+	}
+	return carry;
+}
+
+static MPN_INLINE limb sub1Body(limb* r, const limb* a, size_t n, limb borrow) {
+	size_t i = 0;
+	for (; i < n && borrow != 0; ++i) {
+		bool under = a[i] < borrow;
+		r[i] = a[i] + (under ? Mpn::BASE : 0) - borrow;
+		borrow = under;
+	}
+	if (r != a) {
+		for (; i < n; ++i) {
+			r[i] = a[i];
+		}
+	}
+	return borrow;
+}
+
+static MPN_INLINE limb mulBody(limb* r, const limb* a, size_t n, limb b) {
+	limb carry = 0;
+	for (size_t i = 0; i < n; ++i) {
+		limb product = a[i] * b + carry;
+		r[i] = product % Mpn::BASE;
+		carry = product / Mpn::BASE;
+	}
+	return carry;
+}
+
+static MPN_INLINE limb addmulBody(limb* r, const limb* a, size_t n, limb b) {
+	limb carry = 0;
+	for (size_t i = 0; i < n; ++i) {
+		limb product = r[i] + a[i] * b + carry;
+		r[i] = product % Mpn::BASE;
+		carry = product / Mpn::BASE;
+	}
+	return carry;
+}
+
+// The multiply carry and the subtraction borrow run as two separate chains.
+static MPN_INLINE limb submulBody(limb* r, const limb* a, size_t n, limb b) {
+	limb carry = 0;
+	limb borrow = 0;
+	for (size_t i = 0; i < n; ++i) {
+		limb product = a[i] * b + carry;
+		carry = product / Mpn::BASE;
+		limb subtrahend = product % Mpn::BASE + borrow;
+		borrow = r[i] < subtrahend;
+		r[i] = r[i] + (borrow ? Mpn::BASE : 0) - subtrahend;
+	}
+	return carry + borrow;
+}
+
+static MPN_INLINE limb addmulRowsBody(limb* r, const limb* a, size_t n, const limb* b, size_t m) {
+	limb carry = 0;
+	for (size_t i = 0; i < n; ++i) {
+		limb top = addmulBody(r + i, b, m, a[i]);
+		carry += add1Body(r + i + m, r + i + m, n - i, top);
+	}
+	return carry;
+}
+
+#define MPN_INSTANTIATE(suffix, attributes)                                                                   \
+	attributes static limb add_n_##suffix(limb* r, const limb* a, const limb* b, size_t n) {                 \
+		return addBody(r, a, b, n);                                                                           \
+	}                                                                                                         \
+	attributes static limb sub_n_##suffix(limb* r, const limb* a, const limb* b, size_t n) {                 \
+		return subBody(r, a, b, n);                                                                           \
+	}                                                                                                         \
+	attributes static limb add_1_##suffix(limb* r, const limb* a, size_t n, limb c) { return add1Body(r, a, n, c); } \
+	attributes static limb sub_1_##suffix(limb* r, const limb* a, size_t n, limb c) { return sub1Body(r, a, n, c); } \
+	attributes static limb mul_1_##suffix(limb* r, const limb* a, size_t n, limb b) { return mulBody(r, a, n, b); }  \
+	attributes static limb addmul_1_##suffix(limb* r, const limb* a, size_t n, limb b) {                     \
+		return addmulBody(r, a, n, b);                                                                        \
+	}                                                                                                         \
+	attributes static limb submul_1_##suffix(limb* r, const limb* a, size_t n, limb b) {                     \
+		return submulBody(r, a, n, b);                                                                        \
+	}                                                                                                         \
+	attributes static limb addmul_rows_##suffix(limb* r, const limb* a, size_t n, const limb* b, size_t m) { \
+		return addmulRowsBody(r, a, n, b, m);                                                                 \
+	}
+
+MPN_INSTANTIATE(generic, )
+#if defined(__x86_64__)
+MPN_INSTANTIATE(bmi2, __attribute__((target("bmi,bmi2"))))
+#endif
+
+#if defined(__x86_64__)
+// Vector base case: a block of up to ROWS rows is accumulated column by column (product scanning), each lane
+// holding one output column. _mm*_mul_epu32 multiplies the low 32 bits of 64-bit lanes, which hold a whole limb.
+// A column receives at most ROWS products below 10^18 on top of a limb below BASE, so 16 rows stay below 2^64 and
+// the divisions by BASE happen once per column per block instead of once per product.
+static const size_t ROWS = 16;
+
+// acc holds width unnormalized columns (a multiple of the lane count); padded points at b with ROWS zero limbs in
+// front and at least width zero limbs behind it, so column p of row j reads padded[p - j] without bounds checks.
+__attribute__((target("avx2"))) static void columnsAvx2(limb* acc, size_t width, const limb* a, size_t k,
+                                                        const limb* padded) {
+	__m256i rows[ROWS]{};
+	for (size_t j = 0; j < k; ++j) {
+		rows[j] = _mm256_set1_epi64x(static_cast<long long>(a[j]));
+	}
+	for (size_t p = 0; p < width; p += 4) {
+		__m256i sum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + p));
+		for (size_t j = 0; j < k; ++j) {
+			__m256i column = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(padded + p - j));
+			sum = _mm256_add_epi64(sum, _mm256_mul_epu32(rows[j], column));
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + p), sum);
+	}
+}
+
+// _mm512_maskz_mul_epu32 with a full mask is the same vpmuludq as _mm512_mul_epu32, whose GCC 12 expansion passes an
+// intentionally uninitialized pass-through operand that trips -Wmaybe-uninitialized at -O2 and above.
+__attribute__((target("avx512f"))) static void columnsAvx512(limb* acc, size_t width, const limb* a, size_t k,
+                                                             const limb* padded) {
+	__m512i rows[ROWS]{};
+	for (size_t j = 0; j < k; ++j) {
+		rows[j] = _mm512_set1_epi64(static_cast<long long>(a[j]));
+	}
+	for (size_t p = 0; p < width; p += 8) {
+		__m512i sum = _mm512_loadu_si512(acc + p);
+		for (size_t j = 0; j < k; ++j) {
+			__m512i column = _mm512_loadu_si512(padded + p - j);
+			sum = _mm512_add_epi64(sum, _mm512_maskz_mul_epu32(0xFF, rows[j], column));
+		}
+		_mm512_storeu_si512(acc + p, sum);
+	}
+}
+
+template <size_t LANES, void (*Columns)(limb*, size_t, const limb*, size_t, const limb*)>
+static limb addmulRowsVector(limb* r, const limb* a, size_t n, const limb* b, size_t m) {
+	thread_local std::vector<limb> scratch;
+	size_t width = (std::min(n, ROWS) + m + LANES - 1) / LANES * LANES;
+	scratch.assign(ROWS + m + width + width, 0);
+	limb* padded = scratch.data() + ROWS;
+	limb* acc = padded + m + width;
+	std::copy(b, b + m, padded);
+
+	limb carry = 0;
+	for (size_t i = 0; i < n; i += ROWS) {
+		size_t k = std::min(ROWS, n - i);
+		size_t columns = k + m;
+		std::copy(r + i, r + i + columns, acc);
+		std::fill(acc + columns, acc + width, 0);
+		Columns(acc, (columns + LANES - 1) / LANES * LANES, a + i, k, padded);
+		limb spill = 0;
+		for (size_t p = 0; p < columns; ++p) {
+			limb value = acc[p] + spill;
+			r[i + p] = value % Mpn::BASE;
+			spill = value / Mpn::BASE;
+		}
+		carry += add1Body(r + i + columns, r + i + columns, n - i - k, spill);
+	}
+	return carry;
+}
+#endif
+
+struct MpnKernels {
+	const char* name;
+	limb (*add_n)(limb*, const limb*, const limb*, size_t);
+	limb (*sub_n)(limb*, const limb*, const limb*, size_t);
+	limb (*add_1)(limb*, const limb*, size_t, limb);
+	limb (*sub_1)(limb*, const limb*, size_t, limb);
+	limb (*mul_1)(limb*, const limb*, size_t, limb);
+	limb (*addmul_1)(limb*, const limb*, size_t, limb);
+	limb (*submul_1)(limb*, const limb*, size_t, limb);
+	limb (*addmul_rows)(limb*, const limb*, size_t, const limb*, size_t);
+};
+
+static const MpnKernels genericKernels = {"generic", add_n_generic, sub_n_generic, add_1_generic, sub_1_generic,
+                                          mul_1_generic, addmul_1_generic, submul_1_generic, addmul_rows_generic};
+#if defined(__x86_64__)
+static const MpnKernels bmi2Kernels = {"bmi2", add_n_bmi2, sub_n_bmi2, add_1_bmi2, sub_1_bmi2,
+                                       mul_1_bmi2, addmul_1_bmi2, submul_1_bmi2, addmul_rows_bmi2};
+static const MpnKernels avx2Kernels = {"avx2", add_n_bmi2, sub_n_bmi2, add_1_bmi2, sub_1_bmi2,
+                                       mul_1_bmi2, addmul_1_bmi2, submul_1_bmi2, addmulRowsVector<4, columnsAvx2>};
+static const MpnKernels avx512Kernels = {"avx512", add_n_bmi2, sub_n_bmi2, add_1_bmi2, sub_1_bmi2,
+                                         mul_1_bmi2, addmul_1_bmi2, submul_1_bmi2,
+                                         addmulRowsVector<8, columnsAvx512>};
+#endif
+
+static bool cpuSupports(const std::string& name) {
+	if (name == "generic") {
+		return true;
+	}
+#if defined(__x86_64__)
+	if (name == "bmi2") {
+		return __builtin_cpu_supports("bmi2");
+	}
+	if (name == "avx2") {
+		return __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("avx2");
+	}
+	if (name == "avx512") {
+		return __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("avx512f");
+	}
+#endif
+	return false;
+}
+
+static const MpnKernels* selectKernels(const std::string& name) {
+#if defined(__x86_64__)
+	if (name == "bmi2") {
+		return &bmi2Kernels;
+	}
+	if (name == "avx2") {
+		return &avx2Kernels;
+	}
+	if (name == "avx512") {
+		return &avx512Kernels;
+	}
+#endif
+	return &genericKernels;
+}
+
+// Every limb operation on every thread reads the table, so it is an atomic pointer; the tables themselves are
+// constants, so relaxed ordering is enough for a switch to be seen safely, if not at once, by other threads.
+static std::atomic<const MpnKernels*>& activeKernels() {
+	static std::atomic<const MpnKernels*> active = [] {
+		for (const char* name : {"avx2", "bmi2"}) {
+			if (cpuSupports(name)) {
+				return selectKernels(name);
+			}
+		}
+		return selectKernels("generic");
+	}();
+	return active;
+}
+
+static const MpnKernels* kernels() { return activeKernels().load(std::memory_order_relaxed); }
+
+limb Mpn::add_n(limb* r, const limb* a, const limb* b, size_t n) { return kernels()->add_n(r, a, b, n); }
+
+limb Mpn::sub_n(limb* r, const limb* a, const limb* b, size_t n) { return kernels()->sub_n(r, a, b, n); }
+
+limb Mpn::add_1(limb* r, const limb* a, size_t n, limb c) { return kernels()->add_1(r, a, n, c); }
+
+limb Mpn::sub_1(limb* r, const limb* a, size_t n, limb c) { return kernels()->sub_1(r, a, n, c); }
+
+limb Mpn::mul_1(limb* r, const limb* a, size_t n, limb b) { return kernels()->mul_1(r, a, n, b); }
+
+limb Mpn::addmul_1(limb* r, const limb* a, size_t n, limb b) { return kernels()->addmul_1(r, a, n, b); }
+
+limb Mpn::submul_1(limb* r, const limb* a, size_t n, limb b) { return kernels()->submul_1(r, a, n, b); }
+
+limb Mpn::addmul_rows(limb* r, const limb* a, size_t n, const limb* b, size_t m) {
+	return kernels()->addmul_rows(r, a, n, b, m);
+}
+
+std::string Mpn::implementation() { return kernels()->name; }
+
+bool Mpn::use_implementation(const std::string& name) {
+	if (!cpuSupports(name)) {
+		return false;
+	}
+	activeKernels().store(selectKernels(name), std::memory_order_relaxed);
+	return true;
+}
@@ -0,0 +1,428 @@
+#include "../include/out_of_core.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+static std::system_error fileError(const std::string& what, const std::string& path) {
+	return std::system_error(errno, std::generic_category(), what + " " + path);
+}
+
+LimbFile::LimbFile(const std::string& path, int fd, size_t limbs, bool writable)
+    : path(path), fd(fd), map(nullptr), limbs(limbs), writable(writable) {
+	if (limbs == 0) {
+		return;
+	}
+	void* addr = mmap(nullptr, limbs * sizeof(uint64_t), writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED) {
+		std::system_error error = fileError("Cannot map", path);
+		close(fd);
+		throw error;
+	}
+	map = static_cast<uint64_t*>(addr);
+}
+
+LimbFile LimbFile::open(const std::string& path) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw fileError("Cannot open", path);
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size % sizeof(uint64_t) != 0) {
+		close(fd);
+		throw std::runtime_error("Not a limb file: " + path);
+	}
+	return LimbFile(path, fd, static_cast<size_t>(st.st_size) / sizeof(uint64_t), false);
+}
+
+LimbFile LimbFile::create(const std::string& path, size_t limbs) {
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		throw fileError("Cannot create", path);
+	}
+	if (ftruncate(fd, static_cast<off_t>(limbs * sizeof(uint64_t))) != 0) {
+		std::system_error error = fileError("Cannot resize", path);
+		close(fd);
+		throw error;
+	}
+	return LimbFile(path, fd, limbs, true);
+}
+
+LimbFile LimbFile::temporary(const std::string& directory, size_t limbs) {
+	std::string name = directory + "/.limbs-XXXXXX";
+	int fd = mkstemp(name.data());
+	if (fd < 0) {
+		throw fileError("Cannot create scratch file in", directory);
+	}
+	::unlink(name.c_str());
+	if (ftruncate(fd, static_cast<off_t>(limbs * sizeof(uint64_t))) != 0) {
+		std::system_error error = fileError("Cannot resize", name);
+		close(fd);
+		throw error;
+	}
+	return LimbFile(name, fd, limbs, true);
+}
+
+LimbFile::LimbFile(LimbFile&& other) noexcept
+    : path(std::move(other.path)), fd(other.fd), map(other.map), limbs(other.limbs), writable(other.writable) {
+	other.fd = -1;
+	other.map = nullptr;
+	other.limbs = 0;
+}
+
+LimbFile::~LimbFile() {
+	if (map != nullptr) {
+		munmap(map, limbs * sizeof(uint64_t));
+	}
+	if (fd >= 0) {
+		close(fd);
+	}
+}
+
+size_t LimbFile::size() const { return limbs; }
+
+const uint64_t* LimbFile::data() const { return map; }
+
+uint64_t* LimbFile::data() { return map; }
+
+// Hints apply to whole pages, so the range is widened to page boundaries and clipped to the file.
+void LimbFile::advise(size_t offset, size_t count, int advice) const {
+	if (map == nullptr || offset >= limbs) {
+		return;
+	}
+	count = std::min(count, limbs - offset);
+	static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t begin = offset * sizeof(uint64_t) / page * page;
+	size_t end = (offset + count) * sizeof(uint64_t);
+	madvise(reinterpret_cast<char*>(map) + begin, end - begin, advice);
+}
+
+// Starts write-back of a finished range and lets the kernel drop it from this mapping.
+void LimbFile::flush(size_t offset, size_t count) {
+	if (map == nullptr || offset >= limbs) {
+		return;
+	}
+	count = std::min(count, limbs - offset);
+	static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t begin = offset * sizeof(uint64_t) / page * page;
+	size_t end = (offset + count) * sizeof(uint64_t) / page * page;
+	if (end > begin) {
+		msync(reinterpret_cast<char*>(map) + begin, end - begin, MS_ASYNC);
+		madvise(reinterpret_cast<char*>(map) + begin, end - begin, MADV_DONTNEED);
+	}
+}
+
+bool LimbFile::same_file(const std::string& other) const {
+	struct stat mine;
+	struct stat theirs;
+	if (::stat(other.c_str(), &theirs) != 0 || fstat(fd, &mine) != 0) {
+		return false;
+	}
+	return mine.st_dev == theirs.st_dev && mine.st_ino == theirs.st_ino;
+}
+
+void LimbFile::truncate(size_t new_limbs) {
+	if (!writable || new_limbs > limbs) {
+		throw std::logic_error("Cannot grow or truncate a read-only limb file");
+	}
+	if (map != nullptr) {
+		msync(map, limbs * sizeof(uint64_t), MS_SYNC);
+		munmap(map, limbs * sizeof(uint64_t));
+		map = nullptr;
+	}
+	if (ftruncate(fd, static_cast<off_t>(new_limbs * sizeof(uint64_t))) != 0) {
+		throw fileError("Cannot resize", path);
+	}
+	limbs = 0;
+	if (new_limbs != 0) {
+		void* addr = mmap(nullptr, new_limbs * sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (addr == MAP_FAILED) {
+			throw fileError("Cannot map", path);
+		}
+		map = static_cast<uint64_t*>(addr);
+		limbs = new_limbs;
+	}
+}
+
+OutOfCoreMultiplier::OutOfCoreMultiplier(size_t block_limbs) : blockLimbs(block_limbs) {
+	if (block_limbs == 0) {
+		throw std::invalid_argument("Zero block size");
+	}
+}
+
+void OutOfCoreMultiplier::save(const BigInt& num, const std::string& path) {
+	if (num.isNegative) {
+		throw std::invalid_argument("Limb files hold non-negative numbers");
+	}
+	size_t limbs = num.isNull() ? 0 : num.digits.size();
+	LimbFile file = LimbFile::create(path, limbs);
+	if (limbs != 0) {
+		std::memcpy(file.data(), num.digits.data(), limbs * sizeof(uint64_t));
+	}
+}
+
+BigInt OutOfCoreMultiplier::load(const std::string& path) {
+	LimbFile file = LimbFile::open(path);
+	BigInt result;
+	if (file.size() != 0) {
+		result.digits.assign(file.data(), file.data() + file.size());
+		result.removeLeadingZeros();
+	}
+	return result;
+}
+
+// Arithmetic modulo a prime p = c * 2^k + 1 below 2^62 on values in Montgomery form x * 2^64 mod p, plus the
+// in-memory transforms the passes are built from.
+class OutOfCoreMultiplier::Field {
+   public:
+	using uint128 = BigInt::uint128;
+
+	Field(uint64_t prime, uint64_t generator) : p(prime) {
+		uint64_t inverse = prime;
+		for (int i = 0; i < 5; ++i) {
+			inverse *= 2 - prime * inverse;
+		}
+		negInverse = 0 - inverse;
+		unity = static_cast<uint64_t>((static_cast<uint128>(1) << 64) % prime);
+		r2 = static_cast<uint64_t>(static_cast<uint128>(unity) * unity % prime);
+		primitive = toField(generator);
+	}
+
+	uint64_t prime() const { return p; }
+	uint64_t toField(uint64_t value) const { return mul(value % p, r2); }
+	uint64_t fromField(uint64_t value) const { return reduce(value); }
+
+	uint64_t mul(uint64_t a, uint64_t b) const { return reduce(static_cast<uint128>(a) * b); }
+	uint64_t add(uint64_t a, uint64_t b) const { return a + b >= p ? a + b - p : a + b; }
+	uint64_t sub(uint64_t a, uint64_t b) const { return a >= b ? a - b : a + p - b; }
+
+	uint64_t pow(uint64_t base, uint64_t exp) const {
+		uint64_t result = unity;
+		for (; exp != 0; exp >>= 1) {
+			if (exp & 1) {
+				result = mul(result, base);
+			}
+			base = mul(base, base);
+		}
+		return result;
+	}
+
+	uint64_t inverse(uint64_t value) const { return pow(value, p - 2); }
+
+	// A primitive n-th root of unity (or its inverse) for n dividing p - 1.
+	uint64_t root(size_t n, bool inverse) const { return pow(primitive, (p - 1) / n * (inverse ? n - 1 : 1)); }
+
+	// w^i for i < n / 2, the twiddles of a length-n transform.
+	std::vector<uint64_t> roots(size_t n, bool inverse) const {
+		std::vector<uint64_t> table(std::max<size_t>(1, n / 2), unity);
+		uint64_t w = root(n, inverse);
+		for (size_t i = 1; i < table.size(); ++i) {
+			table[i] = mul(table[i - 1], w);
+		}
+		return table;
+	}
+
+	// Unscaled transform of n = 2^m contiguous values in natural order, with roots from roots(n, inverse).
+	void transform(uint64_t* values, size_t n, const std::vector<uint64_t>& roots) const {
+		for (size_t i = 1, j = 0; i < n; ++i) {
+			size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1) {
+				j ^= bit;
+			}
+			j ^= bit;
+			if (i < j) {
+				std::swap(values[i], values[j]);
+			}
+		}
+		for (size_t half = 1; half < n; half <<= 1) {
+			size_t step = n / (2 * half);
+			for (size_t start = 0; start < n; start += 2 * half) {
+				for (size_t j = 0; j < half; ++j) {
+					uint64_t u = values[start + j];
+					uint64_t v = mul(values[start + j + half], roots[j * step]);
+					values[start + j] = add(u, v);
+					values[start + j + half] = sub(u, v);
+				}
+			}
+		}
+	}
+
+   private:
+	uint64_t p;
+	uint64_t negInverse;
+	uint64_t unity;
+	uint64_t r2;
+	uint64_t primitive;
+
+	uint64_t reduce(uint128 t) const {
+		uint64_t m = static_cast<uint64_t>(t) * negInverse;
+		uint64_t u = static_cast<uint64_t>((t + static_cast<uint128>(m) * p) >> 64);
+		return u >= p ? u - p : u;
+	}
+};
+
+// Primes c * 2^k + 1 with k >= 50 and a primitive root of each. Their product, about 1.9 * 10^37, exceeds every
+// coefficient min(n1, n2) * (10^9 - 1)^2 of a convolution short enough for the transform.
+static const uint64_t PRIMES[2] = {4179340454199820289ULL, 4601552919265804289ULL};
+static const uint64_t GENERATORS[2] = {3, 3};
+static const size_t MAX_TRANSFORM_LENGTH = size_t(1) << 50;
+
+// Transforms of length R down every column, with the four-step twiddle w_L^(column * row) applied after the forward
+// and before the inverse transform. Columns are taken in bands, transposed into a buffer so that each is contiguous.
+void OutOfCoreMultiplier::columnPass(LimbFile& file, size_t rows, size_t columns, const Field& field,
+                                     bool inverse) const {
+	size_t band = std::clamp<size_t>(blockLimbs / rows, 1, columns);
+	std::vector<uint64_t> roots = field.roots(rows, inverse);
+	uint64_t w = field.root(rows * columns, inverse);
+	uint64_t* data = file.data();
+	auto gather = [data, rows, columns, band](size_t first) {
+		size_t width = std::min(band, columns - first);
+		std::vector<uint64_t> slab(width * rows);
+		for (size_t r = 0; r < rows; ++r) {
+			for (size_t c = 0; c < width; ++c) {
+				slab[c * rows + r] = data[r * columns + first + c];
+			}
+		}
+		return slab;
+	};
+
+	std::future<std::vector<uint64_t>> next = std::async(std::launch::async, gather, 0);
+	for (size_t first = 0; first < columns; first += band) {
+		std::vector<uint64_t> slab = next.get();
+		if (first + band < columns) {
+			next = std::async(std::launch::async, gather, first + band);
+		}
+		size_t width = slab.size() / rows;
+		for (size_t c = 0; c < width; ++c) {
+			uint64_t* column = slab.data() + c * rows;
+			uint64_t step = field.pow(w, first + c);
+			auto twiddle = [&] {
+				uint64_t factor = step;
+				for (size_t r = 1; r < rows; ++r) {
+					column[r] = field.mul(column[r], factor);
+					factor = field.mul(factor, step);
+				}
+			};
+			if (inverse) {
+				twiddle();
+				field.transform(column, rows, roots);
+			} else {
+				field.transform(column, rows, roots);
+				twiddle();
+			}
+		}
+		for (size_t r = 0; r < rows; ++r) {
+			for (size_t c = 0; c < width; ++c) {
+				data[r * columns + first + c] = slab[c * rows + r];
+			}
+		}
+	}
+}
+
+// Transforms of length C along every row, in place in the mapping while the rows after the chunk are read ahead.
+void OutOfCoreMultiplier::rowPass(LimbFile& file, size_t rows, size_t columns, const Field& field,
+                                  bool inverse) const {
+	size_t chunk = std::clamp<size_t>(blockLimbs / columns, 1, rows);
+	std::vector<uint64_t> roots = field.roots(columns, inverse);
+	for (size_t first = 0; first < rows; first += chunk) {
+		file.advise((first + chunk) * columns, chunk * columns, MADV_WILLNEED);
+		for (size_t r = first; r < std::min(first + chunk, rows); ++r) {
+			field.transform(file.data() + r * columns, columns, roots);
+		}
+	}
+}
+
+// Leaves in left the cyclic convolution of num1 and num2 modulo the field's prime, in Montgomery form. The forward
+// transform ends with the row pass, so the spectrum is stored transposed; the inverse starts from that order.
+void OutOfCoreMultiplier::convolve(const LimbFile& num1, const LimbFile& num2, LimbFile& left, LimbFile& right,
+                                   size_t rows, size_t columns, const Field& field) const {
+	size_t length = rows * columns;
+	for (auto [source, target] : {std::make_pair(&num1, &left), std::make_pair(&num2, &right)}) {
+		for (size_t first = 0; first < length; first += blockLimbs) {
+			source->advise(first + blockLimbs, blockLimbs, MADV_WILLNEED);
+			for (size_t i = first; i < std::min(first + blockLimbs, length); ++i) {
+				target->data()[i] = i < source->size() ? field.toField(source->data()[i]) : 0;
+			}
+		}
+		if (rows > 1) {
+			columnPass(*target, rows, columns, field, false);
+		}
+		rowPass(*target, rows, columns, field, false);
+	}
+
+	uint64_t scale = field.inverse(field.toField(length));
+	for (size_t i = 0; i < length; ++i) {
+		left.data()[i] = field.mul(field.mul(left.data()[i], right.data()[i]), scale);
+	}
+	rowPass(left, rows, columns, field, true);
+	if (rows > 1) {
+		columnPass(left, rows, columns, field, true);
+	}
+}
+
+void OutOfCoreMultiplier::multiply(const std::string& num1_path, const std::string& num2_path,
+                                   const std::string& out_path) const {
+	LimbFile num1 = LimbFile::open(num1_path);
+	LimbFile num2 = LimbFile::open(num2_path);
+	size_t length = num1.size() + num2.size();
+	size_t transform_length = std::bit_ceil(length);
+	if (transform_length > MAX_TRANSFORM_LENGTH) {
+		throw std::length_error("Product too long for the out-of-core transform");
+	}
+	if (num1.same_file(out_path) || num2.same_file(out_path)) {
+		throw std::invalid_argument("Output file " + out_path + " is also an input");
+	}
+	LimbFile out = LimbFile::create(out_path, length);
+	if (num1.size() == 0 || num2.size() == 0) {
+		out.truncate(0);
+		return;
+	}
+	size_t columns = std::min(transform_length, std::bit_floor(blockLimbs));
+	size_t rows = transform_length / columns;
+	std::filesystem::path parent = std::filesystem::path(out_path).parent_path();
+	std::string directory = (parent.empty() ? std::filesystem::path(".") : parent).string();
+	LimbFile left = LimbFile::temporary(directory, transform_length);
+	LimbFile right = LimbFile::temporary(directory, transform_length);
+
+	// The residues modulo the first prime wait in the output file until the second convolution is done.
+	Field first(PRIMES[0], GENERATORS[0]);
+	convolve(num1, num2, left, right, rows, columns, first);
+	for (size_t i = 0; i < length; ++i) {
+		out.data()[i] = first.fromField(left.data()[i]);
+	}
+	Field second(PRIMES[1], GENERATORS[1]);
+	convolve(num1, num2, left, right, rows, columns, second);
+
+	// Garner: with r0 < p0 < p1, the coefficient is r0 + p0 * ((r1 - r0) * p0^-1 mod p1), below p0 * p1 < 2^128.
+	uint64_t p0_inverse = second.inverse(second.toField(PRIMES[0]));
+	BigInt::uint128 carry = 0;
+	for (size_t first_limb = 0; first_limb < length; first_limb += blockLimbs) {
+		size_t end = std::min(first_limb + blockLimbs, length);
+		for (size_t i = first_limb; i < end; ++i) {
+			uint64_t r0 = out.data()[i];
+			uint64_t r1 = second.fromField(left.data()[i]);
+			uint64_t t = second.mul(second.sub(r1, r0), p0_inverse);
+			BigInt::uint128 value = static_cast<BigInt::uint128>(PRIMES[0]) * t + r0 + carry;
+			out.data()[i] = static_cast<uint64_t>(value % BigInt::BASE);
+			carry = value / BigInt::BASE;
+		}
+		out.flush(first_limb, end - first_limb);
+	}
+
+	while (length > 0 && out.data()[length - 1] == 0) {
+		--length;
+	}
+	out.truncate(length);
+}
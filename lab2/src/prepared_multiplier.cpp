@@ -0,0 +1,38 @@
+#include "../include/prepared_multiplier.hpp"
+
+PreparedMultiplier::PreparedMultiplier(const BigInt& operand) : value(operand), norm(BigInt::fftNorm(operand.digits)) {}
+
+const BigInt& PreparedMultiplier::operand() const { return value; }
+
+std::shared_ptr<const PreparedMultiplier::Spectrum> PreparedMultiplier::spectrum(size_t n) const {
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	auto it = spectra.find(n);
+	if (it == spectra.end()) {
+		it = spectra.emplace(n, std::make_shared<const Spectrum>(BigInt::fftSpectrum(value.digits, n))).first;
+	}
+	return it->second;
+}
+
+// Products whose error bound is too large for the floating point transform go through operator*.
+BigInt PreparedMultiplier::multiply(const BigInt& other) const {
+	size_t n = BigInt::fftSize(value.digits.size(), other.digits.size());
+	if (!BigInt::fftErrorBounded(norm * BigInt::fftNorm(other.digits), n)) {
+		return value * other;
+	}
+	BIGINT_STATS_OP(Multiply);
+	if (value.isNull() || other.isNull()) {
+		return BigInt(0);
+	}
+	BIGINT_STATS_ALGORITHM(Fft, std::max(value.digits.size(), other.digits.size()));
+
+	std::shared_ptr<const Spectrum> prepared = spectrum(n);
+	Spectrum product = BigInt::fftSpectrum(other.digits, n);
+	for (size_t i = 0; i < n; ++i) {
+		product[i] *= (*prepared)[i];
+	}
+	BigInt result;
+	result.digits = BigInt::fftInverse(product);
+	result.isNegative = value.isNegative != other.isNegative;
+	result.removeLeadingZeros();
+	return result;
+}
@@ -0,0 +1,235 @@
+#include <random>
+
+#include "../include/barrett.hpp"
+#include "../include/bigint.hpp"
+
+static const std::vector<unsigned long long>& smallPrimes() {
+	static const std::vector<unsigned long long> primes = [] {
+		std::vector<unsigned long long> result;
+		for (unsigned long long candidate = 2; candidate < 1000; ++candidate) {
+			bool is_prime = true;
+			for (unsigned long long p : result) {
+				if (p * p > candidate) {
+					break;
+				}
+				if (candidate % p == 0) {
+					is_prime = false;
+					break;
+				}
+			}
+			if (is_prime) {
+				result.push_back(candidate);
+			}
+		}
+		return result;
+	}();
+	return primes;
+}
+
+static std::mt19937_64& primeEngine() {
+	thread_local std::mt19937_64 engine{std::random_device{}()};
+	return engine;
+}
+
+static int jacobiSmall(unsigned long long a, unsigned long long n) {
+	int result = 1;
+	a %= n;
+	while (a != 0) {
+		while (a % 2 == 0) {
+			a /= 2;
+			if (n % 8 == 3 || n % 8 == 5) {
+				result = -result;
+			}
+		}
+		std::swap(a, n);
+		if (a % 4 == 3 && n % 4 == 3) {
+			result = -result;
+		}
+		a %= n;
+	}
+	return n == 1 ? result : 0;
+}
+
+// Jacobi symbol (a/n) for a small a and a large odd n, reduced to word size by quadratic reciprocity.
+int BigInt::jacobiSymbol(long long a, const BigInt& n) {
+	int result = 1;
+	unsigned long long n_mod_8 = n.digits[0] % 8;
+	if (a < 0) {
+		a = -a;
+		if (n_mod_8 % 4 == 3) {
+			result = -result;
+		}
+	}
+	unsigned long long value = static_cast<unsigned long long>(a);
+	while (value != 0 && value % 2 == 0) {
+		value /= 2;
+		if (n_mod_8 == 3 || n_mod_8 == 5) {
+			result = -result;
+		}
+	}
+	if (value == 0) {
+		return 0;
+	}
+	if (value % 4 == 3 && n_mod_8 % 4 == 3) {
+		result = -result;
+	}
+	return result * jacobiSmall(n.modSmall(value), value);
+}
+
+// random_bits draws below 2^bits; callers tend to ask for one width over and over, so the last power is kept.
+const BigInt& BigInt::powerOfTwo(size_t bits) {
+	thread_local size_t cachedBits = 0;
+	thread_local BigInt cached(1);
+	if (cachedBits != bits) {
+		cached = pow(BigInt(2), bits);
+		cachedBits = bits;
+	}
+	return cached;
+}
+
+// Strong Lucas probable prime test with Selfridge's parameters (P = 1, Q = (1 - D) / 4).
+bool BigInt::strongLucasTest(const BigInt& n, const BarrettContext& ctx) {
+	long long d_param = 5;
+	for (int attempt = 0;; ++attempt) {
+		int symbol = jacobiSymbol(d_param, n);
+		if (symbol == -1) {
+			break;
+		}
+		if (symbol == 0) {
+			return false;
+		}
+		if (attempt == 8) {
+			BigInt root = isqrt(n);
+			if (root * root == n) {
+				return false;
+			}
+		}
+		d_param = d_param > 0 ? -(d_param + 2) : -d_param + 2;
+	}
+
+	const BigInt d_mod = ctx.reduce(BigInt(d_param));
+	const BigInt q_mod = ctx.reduce(BigInt((1 - d_param) / 4));
+
+	BigInt odd_part = n + BigInt(1);
+	size_t twos = 0;
+	while (odd_part.digits[0] % 2 == 0) {
+		odd_part.divSmall(2);
+		++twos;
+	}
+
+	auto half = [&n](BigInt value) {
+		if (value.digits[0] % 2 != 0) {
+			value += n;
+		}
+		value.divSmall(2);
+		return value;
+	};
+	auto double_step = [&ctx, &n](BigInt& v, BigInt& qk) {
+		v = ctx.mul(v, v) - ctx.reduce(qk + qk);
+		if (v.isNegative) {
+			v += n;
+		}
+		qk = ctx.mul(qk, qk);
+	};
+
+	std::vector<uint32_t> words = odd_part.toBinaryWords();
+	size_t bits = bitLength(words);
+	BigInt u(1);
+	BigInt v(1);
+	BigInt qk = q_mod;
+	for (size_t i = bits - 1; i-- > 0;) {
+		u = ctx.mul(u, v);
+		double_step(v, qk);
+		if ((words[i / 32] >> (i % 32)) & 1) {
+			BigInt next_u = half(ctx.reduce(u + v));
+			v = half(ctx.reduce(ctx.mul(d_mod, u) + v));
+			u = std::move(next_u);
+			qk = ctx.mul(qk, q_mod);
+		}
+	}
+
+	if (u.isNull() || v.isNull()) {
+		return true;
+	}
+	for (size_t r = 1; r < twos; ++r) {
+		double_step(v, qk);
+		if (v.isNull()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BigInt::is_probable_prime(const BigInt& num, int rounds, bool use_bpsw) {
+	if (num.isNegative || num < BigInt(2)) {
+		return false;
+	}
+
+	const std::vector<unsigned long long>& primes = smallPrimes();
+	for (size_t i = 0; i < primes.size();) {
+		unsigned long long group = 1;
+		size_t end = i;
+		while (end < primes.size() && group <= (1ULL << 32) / primes[end]) {
+			group *= primes[end++];
+		}
+		unsigned long long rem = num.modSmall(group);
+		for (; i < end; ++i) {
+			if (rem % primes[i] == 0) {
+				return num == BigInt(static_cast<long long>(primes[i]));
+			}
+		}
+	}
+	if (num < BigInt(1000 * 1000)) {
+		return true;
+	}
+
+	BarrettContext ctx(num);
+	const BigInt n_minus_one = num - BigInt(1);
+	BigInt odd_part = n_minus_one;
+	size_t twos = 0;
+	while (odd_part.digits[0] % 2 == 0) {
+		odd_part.divSmall(2);
+		++twos;
+	}
+
+	auto miller_rabin = [&](const BigInt& witness) {
+		BigInt x = ctx.pow(witness, odd_part);
+		if (x == BigInt(1) || x == n_minus_one) {
+			return true;
+		}
+		for (size_t r = 1; r < twos; ++r) {
+			x = ctx.mul(x, x);
+			if (x == n_minus_one) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	if (use_bpsw && (!miller_rabin(BigInt(2)) || !strongLucasTest(num, ctx))) {
+		return false;
+	}
+	const BigInt witness_range = num - BigInt(3);
+	for (int i = 0; i < rounds; ++i) {
+		if (!miller_rabin(BigInt(2) + random_below(witness_range, primeEngine()))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+BigInt BigInt::random_prime(size_t bits) {
+	if (bits < 2) {
+		throw std::invalid_argument("Prime must have at least 2 bits");
+	}
+	const BigInt low = pow(BigInt(2), bits - 1);
+	while (true) {
+		BigInt candidate = low + random_below(low, primeEngine());
+		if (candidate.digits[0] % 2 == 0 && candidate != BigInt(2)) {
+			++candidate;
+		}
+		if (is_probable_prime(candidate, 5, true)) {
+			return candidate;
+		}
+	}
+}
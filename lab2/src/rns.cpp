@@ -0,0 +1,314 @@
+#include "../include/rns.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+static uint32_t powMod(uint64_t base, uint64_t exp, uint32_t mod) {
+	uint64_t result = 1;
+	base %= mod;
+	while (exp > 0) {
+		if (exp & 1) {
+			result = result * base % mod;
+		}
+		base = base * base % mod;
+		exp >>= 1;
+	}
+	return static_cast<uint32_t>(result);
+}
+
+// Miller-Rabin with bases 2, 7 and 61 is exact below 2^32.
+static bool isPrime32(uint32_t n) {
+	if (n < 2 || n % 2 == 0) {
+		return n == 2;
+	}
+	uint32_t d = n - 1;
+	int s = 0;
+	while (d % 2 == 0) {
+		d /= 2;
+		++s;
+	}
+	for (uint32_t a : {2u, 7u, 61u}) {
+		if (a % n == 0) {
+			continue;
+		}
+		uint64_t x = powMod(a, d, n);
+		if (x == 1 || x == n - 1) {
+			continue;
+		}
+		bool composite = true;
+		for (int i = 1; i < s && composite; ++i) {
+			x = x * x % n;
+			composite = x != n - 1;
+		}
+		if (composite) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Lane kernels over k residues, each below its prime p < 2^31. Sums and differences are corrected with an unsigned
+// min (the wrong candidate wraps above 2^31). Products use a double-precision quotient estimate off by at most one,
+// so the remainder a * b - q * p lands in (-p, 2p) and two conditional corrections finish it.
+#define RNS_INLINE inline __attribute__((always_inline))
+
+static RNS_INLINE void addBody(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p, size_t i,
+                               size_t k) {
+	for (; i < k; ++i) {
+		uint32_t sum = a[i] + b[i];
+		r[i] = std::min(sum, sum - p[i]);
+	}
+}
+
+static RNS_INLINE void subBody(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p, size_t i,
+                               size_t k) {
+	for (; i < k; ++i) {
+		uint32_t diff = a[i] - b[i];
+		r[i] = std::min(diff, diff + p[i]);
+	}
+}
+
+static RNS_INLINE void mulBody(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p, size_t i,
+                               size_t k) {
+	for (; i < k; ++i) {
+		r[i] = static_cast<uint32_t>(static_cast<uint64_t>(a[i]) * b[i] % p[i]);
+	}
+}
+
+static void addGeneric(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p, const double*, size_t k) {
+	addBody(r, a, b, p, 0, k);
+}
+
+static void subGeneric(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p, const double*, size_t k) {
+	subBody(r, a, b, p, 0, k);
+}
+
+static void mulGeneric(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p, const double*, size_t k) {
+	mulBody(r, a, b, p, 0, k);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) static void addAvx2(uint32_t* r, const uint32_t* a, const uint32_t* b,
+                                                    const uint32_t* p, const double*, size_t k) {
+	size_t i = 0;
+	for (; i + 8 <= k; i += 8) {
+		__m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+		__m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+		__m256i vp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+		__m256i sum = _mm256_add_epi32(va, vb);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_min_epu32(sum, _mm256_sub_epi32(sum, vp)));
+	}
+	addBody(r, a, b, p, i, k);
+}
+
+__attribute__((target("avx2"))) static void subAvx2(uint32_t* r, const uint32_t* a, const uint32_t* b,
+                                                    const uint32_t* p, const double*, size_t k) {
+	size_t i = 0;
+	for (; i + 8 <= k; i += 8) {
+		__m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+		__m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+		__m256i vp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+		__m256i diff = _mm256_sub_epi32(va, vb);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_min_epu32(diff, _mm256_add_epi32(diff, vp)));
+	}
+	subBody(r, a, b, p, i, k);
+}
+
+__attribute__((target("avx2"))) static void mulAvx2(uint32_t* r, const uint32_t* a, const uint32_t* b,
+                                                    const uint32_t* p, const double* inv, size_t k) {
+	const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	const __m256i zero = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 4 <= k; i += 4) {
+		__m128i a32 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+		__m128i b32 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+		__m128i p32 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+		__m256d estimate = _mm256_mul_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(a32), _mm256_cvtepi32_pd(b32)),
+		                                 _mm256_loadu_pd(inv + i));
+		__m256i q = _mm256_cvtepu32_epi64(_mm256_cvttpd_epi32(estimate));
+		__m256i vp = _mm256_cvtepu32_epi64(p32);
+		__m256i product = _mm256_mul_epu32(_mm256_cvtepu32_epi64(a32), _mm256_cvtepu32_epi64(b32));
+		__m256i rem = _mm256_sub_epi64(product, _mm256_mul_epu32(q, vp));
+		rem = _mm256_add_epi64(rem, _mm256_and_si256(_mm256_cmpgt_epi64(zero, rem), vp));
+		rem = _mm256_sub_epi64(rem, _mm256_andnot_si256(_mm256_cmpgt_epi64(vp, rem), vp));
+		__m256i packed = _mm256_permutevar8x32_epi32(rem, pack);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), _mm256_castsi256_si128(packed));
+	}
+	mulBody(r, a, b, p, i, k);
+}
+#endif
+
+struct RnsKernels {
+	void (*add)(uint32_t*, const uint32_t*, const uint32_t*, const uint32_t*, const double*, size_t);
+	void (*sub)(uint32_t*, const uint32_t*, const uint32_t*, const uint32_t*, const double*, size_t);
+	void (*mul)(uint32_t*, const uint32_t*, const uint32_t*, const uint32_t*, const double*, size_t);
+};
+
+static const RnsKernels& kernels() {
+	static const RnsKernels generic = {addGeneric, subGeneric, mulGeneric};
+#if defined(__x86_64__)
+	static const RnsKernels avx2 = {addAvx2, subAvx2, mulAvx2};
+	static const RnsKernels& active = __builtin_cpu_supports("avx2") ? avx2 : generic;
+	return active;
+#else
+	return generic;
+#endif
+}
+
+RnsBasis::RnsBasis(size_t bits) {
+	double covered = 0;
+	for (uint32_t candidate = (1u << 31) - 1; covered < static_cast<double>(bits) + 2; candidate -= 2) {
+		if (isPrime32(candidate)) {
+			moduli.push_back(candidate);
+			inverses.push_back(1.0 / candidate);
+			covered += std::log2(static_cast<double>(candidate));
+		}
+	}
+
+	weights.resize(moduli.size());
+	for (size_t i = 0; i < moduli.size(); ++i) {
+		uint64_t cofactor = 1;
+		for (size_t j = 0; j < moduli.size(); ++j) {
+			if (j != i) {
+				cofactor = cofactor * (moduli[j] % moduli[i]) % moduli[i];
+			}
+		}
+		weights[i] = powMod(cofactor, moduli[i] - 2, moduli[i]);
+	}
+
+	tree.emplace_back();
+	for (uint32_t prime : moduli) {
+		tree[0].push_back(BigInt(static_cast<long long>(prime)));
+	}
+	while (tree.back().size() > 1) {
+		const std::vector<BigInt>& below = tree.back();
+		std::vector<BigInt> level;
+		for (size_t i = 0; i + 1 < below.size(); i += 2) {
+			level.push_back(below[i] * below[i + 1]);
+		}
+		if (below.size() % 2 == 1) {
+			level.push_back(below.back());
+		}
+		tree.push_back(std::move(level));
+	}
+	for (size_t level = 0; level < tree.size(); ++level) {
+		reducers.emplace_back();
+		if (level >= LEAF_LEVEL) {
+			for (const BigInt& node : tree[level]) {
+				reducers.back().emplace_back(node);
+			}
+		}
+	}
+	half = modulus();
+	half.divSmall(2);
+}
+
+size_t RnsBasis::size() const { return moduli.size(); }
+
+size_t RnsBasis::bits() const {
+	double covered = 0;
+	for (uint32_t prime : moduli) {
+		covered += std::log2(static_cast<double>(prime));
+	}
+	return static_cast<size_t>(covered) - 2;
+}
+
+const std::vector<uint32_t>& RnsBasis::primes() const { return moduli; }
+
+const BigInt& RnsBasis::modulus() const { return tree.back()[0]; }
+
+// Remainder tree: |value| mod M, then each node's remainder reduced by its two children (Barrett, since a parent
+// remainder is below the square of either child) down to nodes of LEAF_PRIMES primes, which finish with a
+// Horner scan of their remainder's limbs for every prime.
+std::vector<uint32_t> RnsBasis::residues(const BigInt& value) const {
+	std::vector<BigInt> rems{value.isNegative ? BigInt(0) - value : value};
+	rems[0] = rems[0] < modulus() ? rems[0] : rems[0] % modulus();
+	size_t leaf = std::min(LEAF_LEVEL, tree.size() - 1);
+	for (size_t level = tree.size() - 1; level-- > leaf;) {
+		std::vector<BigInt> next(tree[level].size());
+		for (size_t i = 0; i < next.size(); ++i) {
+			next[i] = rems[i / 2] < tree[level][i] ? rems[i / 2] : reducers[level][i].reduce(rems[i / 2]);
+		}
+		rems = std::move(next);
+	}
+	std::vector<uint32_t> result(moduli.size());
+	for (size_t i = 0; i < moduli.size(); ++i) {
+		const BigInt::Limbs& digits = rems[i >> leaf].digits;
+		uint64_t residue = 0;
+		for (size_t j = digits.size(); j-- > 0;) {
+			residue = (residue * BigInt::BASE + digits[j]) % moduli[i];
+		}
+		result[i] = value.isNegative && residue != 0 ? moduli[i] - static_cast<uint32_t>(residue)
+		                                             : static_cast<uint32_t>(residue);
+	}
+	return result;
+}
+
+// CRT up the product tree: a node covering primes S carries sum over i in S of c_i * (M_S / p_i) with
+// c_i = r_i * weight_i mod p_i, and two children combine as left * M_right + right * M_left.
+BigInt RnsBasis::reconstruct(const std::vector<uint32_t>& residues) const {
+	std::vector<BigInt> sums(moduli.size());
+	for (size_t i = 0; i < moduli.size(); ++i) {
+		sums[i] = BigInt(static_cast<long long>(static_cast<uint64_t>(residues[i]) * weights[i] % moduli[i]));
+	}
+	for (size_t level = 0; level + 1 < tree.size(); ++level) {
+		const std::vector<BigInt>& nodes = tree[level];
+		std::vector<BigInt> next;
+		for (size_t i = 0; i + 1 < nodes.size(); i += 2) {
+			next.push_back(sums[i] * nodes[i + 1] + sums[i + 1] * nodes[i]);
+		}
+		if (nodes.size() % 2 == 1) {
+			next.push_back(sums.back());
+		}
+		sums = std::move(next);
+	}
+	BigInt value = sums[0] % modulus();
+	return value > half ? value - modulus() : value;
+}
+
+RnsInt::RnsInt(std::shared_ptr<const RnsBasis> basis, const BigInt& value)
+    : base(std::move(basis)), lanes(base->residues(value)) {}
+
+void RnsInt::checkBasis(const RnsInt& other) const {
+	if (base != other.base) {
+		throw std::invalid_argument("RnsInt operands use different bases");
+	}
+}
+
+RnsInt& RnsInt::operator+=(const RnsInt& other) {
+	checkBasis(other);
+	kernels().add(lanes.data(), lanes.data(), other.lanes.data(), base->moduli.data(), base->inverses.data(),
+	              lanes.size());
+	return *this;
+}
+
+RnsInt& RnsInt::operator-=(const RnsInt& other) {
+	checkBasis(other);
+	kernels().sub(lanes.data(), lanes.data(), other.lanes.data(), base->moduli.data(), base->inverses.data(),
+	              lanes.size());
+	return *this;
+}
+
+RnsInt& RnsInt::operator*=(const RnsInt& other) {
+	checkBasis(other);
+	kernels().mul(lanes.data(), lanes.data(), other.lanes.data(), base->moduli.data(), base->inverses.data(),
+	              lanes.size());
+	return *this;
+}
+
+RnsInt RnsInt::operator+(const RnsInt& other) const { return RnsInt(*this) += other; }
+
+RnsInt RnsInt::operator-(const RnsInt& other) const { return RnsInt(*this) -= other; }
+
+RnsInt RnsInt::operator*(const RnsInt& other) const { return RnsInt(*this) *= other; }
+
+BigInt RnsInt::to_bigint() const { return base->reconstruct(lanes); }
+
+const std::vector<uint32_t>& RnsInt::residues() const { return lanes; }
+
+const std::shared_ptr<const RnsBasis>& RnsInt::basis() const { return base; }
@@ -0,0 +1,57 @@
+#include "../include/rsa.hpp"
+
+#include <future>
+#include <stdexcept>
+
+RsaPrivateKey::RsaPrivateKey(BigInt p, BigInt q, BigInt d_p, BigInt d_q, BigInt q_inv)
+    : p(checkedPrime(std::move(p), q, d_p, d_q, q_inv)),
+      q(std::move(q)),
+      dP(std::move(d_p)),
+      dQ(std::move(d_q)),
+      qInv(std::move(q_inv)),
+      n(this->p * this->q),
+      modP(this->p),
+      modQ(this->q) {}
+
+// Runs ahead of the member initializers so that bad parameters are rejected before any Barrett precomputation.
+BigInt RsaPrivateKey::checkedPrime(BigInt p, const BigInt& q, const BigInt& d_p, const BigInt& d_q,
+                                   const BigInt& q_inv) {
+	if (p <= BigInt(2) || q <= BigInt(2)) {
+		throw std::invalid_argument("RSA primes must be greater than 2");
+	}
+	BigInt check = q_inv * q % p;
+	if (d_p < BigInt(0) || d_q < BigInt(0) || (check != BigInt(1) && check != BigInt(1) - p)) {
+		throw std::invalid_argument("Inconsistent RSA CRT parameters");
+	}
+	return p;
+}
+
+RsaPrivateKey RsaPrivateKey::from_primes(const BigInt& p, const BigInt& q, const BigInt& e) {
+	if (p == q) {
+		throw std::invalid_argument("RSA primes must be distinct");
+	}
+	BigInt d_p = BigInt::mod_inverse(e, p - BigInt(1));
+	BigInt d_q = BigInt::mod_inverse(e, q - BigInt(1));
+	return RsaPrivateKey(p, q, d_p, d_q, BigInt::mod_inverse(q, p));
+}
+
+const BigInt& RsaPrivateKey::modulus() const { return n; }
+
+BigInt RsaPrivateKey::apply(const BigInt& input, bool concurrent) const {
+	if (input < BigInt(0) || input >= n) {
+		throw std::invalid_argument("RSA input must lie in [0, n)");
+	}
+	auto half_p = [this, &input] { return modP.pow(modP.reduce(input), dP); };
+	BigInt m1;
+	BigInt m2;
+	if (concurrent) {
+		std::future<BigInt> pending = std::async(std::launch::async, half_p);
+		m2 = modQ.pow(modQ.reduce(input), dQ);
+		m1 = pending.get();
+	} else {
+		m1 = half_p();
+		m2 = modQ.pow(modQ.reduce(input), dQ);
+	}
+	BigInt h = modP.mul(qInv, modP.reduce(m1 - m2));
+	return m2 + h * q;
+}
@@ -0,0 +1,83 @@
+#include "../include/series.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+static const size_t SERIES_GUARD_DIGITS = 10;
+
+HypergeometricSeries::HypergeometricSeries(Term p, Term q, Term a, std::function<double(unsigned long long)> log10_ratio)
+    : p(std::move(p)), q(std::move(q)), a(std::move(a)), log10Ratio(std::move(log10_ratio)) {}
+
+// P(b, e) = p(b)...p(e-1), Q(b, e) = q(b)...q(e-1) and T(b, e) = Q(b, e) * sum_{k=b}^{e-1} a(k) p(b)...p(k) / (q(b)...q(k)),
+// merged as P = P1 P2, Q = Q1 Q2, T = T1 Q2 + P1 T2.
+HypergeometricSeries::Split HypergeometricSeries::split(unsigned long long begin, unsigned long long end) const {
+	if (begin >= end) {
+		throw std::invalid_argument("Empty series range");
+	}
+	if (end - begin == 1) {
+		BigInt pk = p(begin);
+		return {pk, q(begin), a(begin) * pk};
+	}
+	unsigned long long mid = begin + (end - begin) / 2;
+	Split left = split(begin, mid);
+	Split right = split(mid, end);
+	return {left.p * right.p, left.q * right.q, left.t * right.q + left.p * right.t};
+}
+
+unsigned long long HypergeometricSeries::terms(size_t digits) const {
+	double accumulated = 0;
+	unsigned long long count = 1;
+	while (accumulated <= static_cast<double>(digits + SERIES_GUARD_DIGITS)) {
+		accumulated += log10Ratio(count);
+		++count;
+	}
+	return count;
+}
+
+BigFloat HypergeometricSeries::sum(size_t digits) const {
+	Split total = split(0, terms(digits));
+	size_t precision = digits + SERIES_GUARD_DIGITS;
+	return BigFloat(total.t, precision) / BigFloat(total.q, precision);
+}
+
+// pi = 426880 sqrt(10005) / S with S = sum (6k)! (13591409 + 545140134 k) / ((3k)! (k!)^3 (-640320)^(3k)); the ratio of
+// consecutive terms gives p(k) = -(6k - 5)(2k - 1)(6k - 1) and q(k) = k^3 640320^3 / 24.
+HypergeometricSeries HypergeometricSeries::chudnovsky() {
+	static const BigInt c3_over_24("10939058860032000");
+	return HypergeometricSeries(
+	    [](unsigned long long k) {
+		    if (k == 0) {
+			    return BigInt(1);
+		    }
+		    long long kk = static_cast<long long>(k);
+		    return BigInt(-(6 * kk - 5)) * BigInt(2 * kk - 1) * BigInt(6 * kk - 1);
+	    },
+	    [](unsigned long long k) {
+		    if (k == 0) {
+			    return BigInt(1);
+		    }
+		    BigInt kk(static_cast<long long>(k));
+		    return kk * kk * kk * c3_over_24;
+	    },
+	    [](unsigned long long k) { return BigInt(13591409) + BigInt(545140134) * BigInt(static_cast<long long>(k)); },
+	    [](unsigned long long) { return std::log10(151931373056000.0); });
+}
+
+// e = sum 1 / k!.
+HypergeometricSeries HypergeometricSeries::euler() {
+	return HypergeometricSeries([](unsigned long long) { return BigInt(1); },
+	                            [](unsigned long long k) { return BigInt(static_cast<long long>(k == 0 ? 1 : k)); },
+	                            [](unsigned long long) { return BigInt(1); },
+	                            [](unsigned long long k) { return std::log10(static_cast<double>(k)); });
+}
+
+BigFloat HypergeometricSeries::pi(size_t digits) {
+	HypergeometricSeries series = chudnovsky();
+	Split total = series.split(0, series.terms(digits));
+	size_t precision = digits + SERIES_GUARD_DIGITS;
+	BigFloat root = BigFloat::sqrt(BigFloat(10005, precision));
+	BigFloat result = BigFloat(total.q * BigInt(426880), precision) * root / BigFloat(total.t, precision);
+	return result.with_precision(digits);
+}
+
+BigFloat HypergeometricSeries::e(size_t digits) { return euler().sum(digits).with_precision(digits); }
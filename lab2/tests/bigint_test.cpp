@@ -1,9 +1,40 @@
 #include "../include/bigint.hpp"
+#include "../include/async_ops.hpp"
+#include "../include/barrett.hpp"
+#include "../include/bigfloat.hpp"
+#include "../include/bigint_accumulator.hpp"
+#include "../include/bigint_array.hpp"
+#include "../include/bigint_client.hpp"
+#include "../include/bigint_server.hpp"
+#include "../include/expression.hpp"
+#include "../include/factor.hpp"
+#include "../include/fixed_base_exp.hpp"
+#include "../include/fixed_bigint.hpp"
+#include "../include/mpn.hpp"
+#include "../include/out_of_core.hpp"
+#include "../include/prepared_multiplier.hpp"
+#include "../include/rns.hpp"
+#include "../include/rsa.hpp"
+#include "../include/series.hpp"
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <limits>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -443,4 +474,998 @@ TEST_F(BigIntTest, FFT) {
 	BigInt::fft(fft1, false);
 	BigInt::fft(fft1, true);
 	EXPECT_EQ(fft1, BigInt{"9321"});
-}
\ No newline at end of file
+}
+
+TEST_F(BigIntTest, Gcd) {
+	EXPECT_EQ(BigInt::gcd(BigInt(12), BigInt(18)), BigInt(6));
+	EXPECT_EQ(BigInt::gcd(BigInt(-12), BigInt(18)), BigInt(6));
+	EXPECT_EQ(BigInt::gcd(zero, neg_small), pos_small);
+	EXPECT_EQ(BigInt::gcd(zero, zero), zero);
+	EXPECT_EQ(BigInt::gcd(base_val, base_times_two), base_val);
+
+	BigInt p1("170141183460469231731687303715884105727");
+	BigInt p2("618970019642690137449562111");
+	BigInt common("987654321987654321987654321");
+	EXPECT_EQ(BigInt::gcd(p1 * common, p2 * common), common);
+	EXPECT_EQ(BigInt::gcd(p1 * p2 * common, common * common), common);
+	EXPECT_EQ(BigInt::gcd(p1, p2), one);
+
+	BigInt fib_prev(1), fib(1);
+	for (int i = 0; i < 300; ++i) {
+		BigInt next = fib + fib_prev;
+		fib_prev = fib;
+		fib = next;
+	}
+	EXPECT_EQ(BigInt::gcd(fib, fib_prev), one);
+}
+
+TEST_F(BigIntTest, ExtendedGcdAndInverse) {
+	BigInt x, y;
+	BigInt a("123456789012345678901234567890123");
+	BigInt b("-98765432109876543210987654321");
+	BigInt g = BigInt::extended_gcd(a, b, x, y);
+	EXPECT_EQ(g, BigInt::gcd(a, b));
+	EXPECT_EQ(a * x + b * y, g);
+
+	g = BigInt::extended_gcd(zero, pos_small, x, y);
+	EXPECT_EQ(g, pos_small);
+	EXPECT_EQ(pos_small * y, g);
+
+	BigInt mod("170141183460469231731687303715884105727");
+	BigInt inv = BigInt::mod_inverse(a, mod);
+	EXPECT_EQ((a * inv) % mod, one);
+	EXPECT_EQ(BigInt::mod_inverse(BigInt(3), BigInt(7)), BigInt(5));
+	EXPECT_EQ(BigInt::mod_inverse(BigInt(-3), BigInt(7)), BigInt(2));
+	EXPECT_THROW(BigInt::mod_inverse(BigInt(4), BigInt(8)), std::invalid_argument);
+	EXPECT_THROW(BigInt::mod_inverse(BigInt(4), zero), std::runtime_error);
+}
+
+TEST_F(BigIntTest, DivisionLarge) {
+	BigInt a("123456789012345678901234567890123456789012345678901234567890");
+	BigInt b("987654321098765432109876543");
+	BigInt q = a / b;
+	BigInt r = a % b;
+	EXPECT_EQ(q, BigInt("124999998860937500014238281276525"));
+	EXPECT_EQ(q * b + r, a);
+	EXPECT_LT(r, b);
+	EXPECT_EQ((zero - a) / b, zero - q);
+	EXPECT_EQ((zero - a) % b, zero - r);
+	EXPECT_EQ(a / (zero - b), zero - q);
+	EXPECT_EQ(a % (zero - b), r);
+
+	BigInt all_nines("999999999999999999999999999999999999");
+	BigInt divisor("999999999000000000");
+	EXPECT_EQ(all_nines / divisor * divisor + all_nines % divisor, all_nines);
+	EXPECT_EQ(b / a, zero);
+	EXPECT_EQ(b % a, b);
+}
+
+TEST_F(BigIntTest, Roots) {
+	BigInt rem;
+	EXPECT_EQ(BigInt::isqrt(zero), zero);
+	EXPECT_EQ(BigInt::isqrt(BigInt(15)), BigInt(3));
+	EXPECT_EQ(BigInt::isqrt(BigInt(16)), BigInt(4));
+	EXPECT_EQ(BigInt::sqrtrem(BigInt(17), rem), BigInt(4));
+	EXPECT_EQ(rem, one);
+
+	BigInt root("31415926535897932384626433832795028841971693993751");
+	BigInt square = root * root;
+	EXPECT_EQ(BigInt::isqrt(square), root);
+	EXPECT_EQ(BigInt::isqrt(square - one), root - one);
+	EXPECT_EQ(BigInt::sqrtrem(square + root, rem), root);
+	EXPECT_EQ(rem, root);
+
+	BigInt cube = root * root * root;
+	EXPECT_EQ(BigInt::iroot(cube, 3), root);
+	EXPECT_EQ(BigInt::iroot(cube - one, 3), root - one);
+	EXPECT_EQ(BigInt::iroot(zero - cube, 3), zero - root);
+	EXPECT_EQ(BigInt::rootrem(cube + ten, 3, rem), root);
+	EXPECT_EQ(rem, ten);
+	EXPECT_EQ(BigInt::iroot(BigInt::pow(BigInt(2), 200), 100), BigInt(4));
+	EXPECT_EQ(BigInt::iroot(BigInt(1000), 50), one);
+	EXPECT_EQ(BigInt::iroot(pos_small, 1), pos_small);
+	EXPECT_EQ(BigInt::pow(ten, 20), BigInt("100000000000000000000"));
+
+	EXPECT_THROW(BigInt::isqrt(neg_one), std::invalid_argument);
+	EXPECT_THROW(BigInt::iroot(ten, 0), std::invalid_argument);
+}
+
+TEST_F(BigIntTest, KaratsubaLarge) {
+	std::string digits1, digits2;
+	for (int i = 0; i < 900; ++i) {
+		digits1 += static_cast<char>('1' + (i * 7) % 9);
+		digits2 += static_cast<char>('9' - (i * 5) % 9);
+	}
+	BigInt a(digits1);
+	BigInt b(digits2);
+	BigInt expected = a;
+	expected *= b;
+	EXPECT_EQ(BigInt::karatsuba(a, b), expected);
+	EXPECT_EQ(BigInt::karatsuba(a, BigInt(digits2.substr(0, 350))), a * BigInt(digits2.substr(0, 350)));
+	EXPECT_EQ((a * b) / b, a);
+	EXPECT_EQ(BigInt::karatsuba(zero - a, b), zero - expected);
+}
+
+TEST_F(BigIntTest, ProductFactorialBinomial) {
+	std::vector<BigInt> values = {BigInt(2), BigInt(3), BigInt(5), BigInt(-7), base_val};
+	EXPECT_EQ(BigInt::product(values), BigInt("-210000000000"));
+	EXPECT_EQ(BigInt::product({}), one);
+
+	EXPECT_EQ(BigInt::factorial(0), one);
+	EXPECT_EQ(BigInt::factorial(1), one);
+	EXPECT_EQ(BigInt::factorial(20), BigInt("2432902008176640000"));
+	EXPECT_EQ(BigInt::factorial(30), BigInt("265252859812191058636308480000000"));
+	BigInt naive(1);
+	for (int i = 2; i <= 300; ++i) {
+		naive *= BigInt(i);
+	}
+	EXPECT_EQ(BigInt::factorial(300), naive);
+
+	EXPECT_EQ(BigInt::binomial(5, 2), ten);
+	EXPECT_EQ(BigInt::binomial(10, 0), one);
+	EXPECT_EQ(BigInt::binomial(3, 4), zero);
+	EXPECT_EQ(BigInt::binomial(100, 50), BigInt("100891344545564193334812497256"));
+	EXPECT_EQ(BigInt::binomial(300, 120), BigInt::factorial(300) / (BigInt::factorial(120) * BigInt::factorial(180)));
+}
+
+TEST_F(BigIntTest, BarrettAndModExp) {
+	BigInt mod("170141183460469231731687303715884105727");
+	BarrettContext ctx(mod);
+	BigInt a("98765432109876543210987654321098765432");
+	BigInt b("12345678901234567890123456789012345678");
+	EXPECT_EQ(ctx.mul(a, b), (a * b) % mod);
+	EXPECT_EQ(ctx.reduce(zero - a), mod - a);
+	EXPECT_EQ(ctx.reduce(a * b * a), (a * b * a) % mod);
+	EXPECT_EQ(ctx.pow(a, mod - one), one);
+	EXPECT_EQ(BigInt::mod_exp(BigInt(3), BigInt(1000), base_val), BigInt::pow(BigInt(3), 1000) % base_val);
+	EXPECT_EQ(BigInt::mod_exp(b, a, mod), BigInt::mod_exp(b, a % (mod - one), mod));
+}
+
+TEST_F(BigIntTest, Primality) {
+	EXPECT_FALSE(BigInt::is_probable_prime(zero));
+	EXPECT_FALSE(BigInt::is_probable_prime(one));
+	EXPECT_FALSE(BigInt::is_probable_prime(BigInt(-7)));
+	EXPECT_TRUE(BigInt::is_probable_prime(BigInt(2)));
+	EXPECT_TRUE(BigInt::is_probable_prime(BigInt(997)));
+	EXPECT_FALSE(BigInt::is_probable_prime(BigInt(561)));
+	EXPECT_TRUE(BigInt::is_probable_prime(BigInt(1000000007)));
+	EXPECT_TRUE(BigInt::is_probable_prime(BigInt("170141183460469231731687303715884105727"), 10, true));
+	EXPECT_TRUE(BigInt::is_probable_prime(BigInt("618970019642690137449562111")));
+	EXPECT_FALSE(BigInt::is_probable_prime(BigInt("618970019642690137449562111") * BigInt(1000000007), 10, true));
+
+	BigInt strong_pseudoprime("3825123056546413051");
+	EXPECT_FALSE(BigInt::is_probable_prime(strong_pseudoprime, 0, true));
+	EXPECT_FALSE(BigInt::is_probable_prime(strong_pseudoprime));
+	EXPECT_FALSE(BigInt::is_probable_prime(BigInt(1000003) * BigInt(1000003), 0, true));
+
+	BigInt prime = BigInt::random_prime(96);
+	EXPECT_EQ(prime.bit_length(), 96u);
+	EXPECT_TRUE(BigInt::is_probable_prime(prime, 10, true));
+	EXPECT_THROW(BigInt::random_prime(1), std::invalid_argument);
+}
+
+TEST(BigIntBits, BitLengthAroundPowersOfTwo) {
+	EXPECT_EQ(BigInt(0).bit_length(), 0u);
+	EXPECT_EQ(BigInt(-8).bit_length(), 4u);
+	BigInt power(1);
+	for (size_t k = 0; k < 700; ++k, power *= BigInt(2)) {
+		EXPECT_EQ((power - BigInt(1)).bit_length(), k);
+		EXPECT_EQ(power.bit_length(), k + 1);
+		EXPECT_EQ((power + BigInt(1)).bit_length(), k == 0 ? 2 : k + 1);
+	}
+	BigInt huge = BigInt::pow(BigInt(2), 300000);
+	EXPECT_EQ(huge.bit_length(), 300001u);
+	EXPECT_EQ((huge - BigInt(1)).bit_length(), 300000u);
+	EXPECT_EQ((huge * BigInt(3)).bit_length(), 300002u);
+}
+
+TEST_F(BigIntTest, FixedBaseExp) {
+	BigInt mod("170141183460469231731687303715884105727");
+	BigInt generator("3");
+	FixedBaseExp fixed(generator, mod, 128);
+	EXPECT_EQ(fixed.pow(zero), one);
+	EXPECT_EQ(fixed.pow(one), generator);
+	EXPECT_EQ(fixed.pow(mod - one), one);
+
+	std::vector<BigInt> exps;
+	BigInt exp("123456789123456789");
+	for (int i = 0; i < 20; ++i) {
+		exps.push_back(exp);
+		exp = (exp * exp + BigInt(i)) % mod;
+	}
+	std::vector<BigInt> results = fixed.pow_batch(exps, 3);
+	ASSERT_EQ(results.size(), exps.size());
+	for (size_t i = 0; i < exps.size(); ++i) {
+		EXPECT_EQ(results[i], BigInt::mod_exp(generator, exps[i], mod));
+	}
+
+	BigInt wide_exp = mod * mod;
+	EXPECT_EQ(fixed.pow(wide_exp), BigInt::mod_exp(generator, wide_exp, mod));
+	FixedBaseExp narrow(BigInt(-5), BigInt(1000003), 20, 3);
+	EXPECT_EQ(narrow.pow(BigInt(999999)), BigInt::mod_exp(BigInt(-5), BigInt(999999), BigInt(1000003)));
+	EXPECT_TRUE(narrow.pow_batch({}).empty());
+	EXPECT_THROW(fixed.pow(neg_one), std::invalid_argument);
+	EXPECT_THROW(fixed.pow_batch({one, neg_one}), std::invalid_argument);
+}
+
+template <typename T>
+class FixedBigIntTest : public ::testing::Test {
+   protected:
+	BigInt modulus = BigInt::pow(BigInt(2), T::LIMBS * 64);
+	std::vector<BigInt> samples;
+
+	void SetUp() override {
+		BigInt value("1000000005");
+		while (value < modulus) {
+			samples.push_back(value);
+			value = value * value + BigInt(987654321);
+		}
+		samples.push_back(modulus - BigInt(1));
+		samples.push_back(BigInt(1));
+	}
+};
+
+using FixedWidths = ::testing::Types<FixedBigInt<64>, FixedBigInt<256>, FixedBigInt<512>>;
+TYPED_TEST_SUITE(FixedBigIntTest, FixedWidths);
+
+TYPED_TEST(FixedBigIntTest, MatchesBigInt) {
+	const BigInt& mod = this->modulus;
+	for (const BigInt& a : this->samples) {
+		TypeParam fa(a);
+		EXPECT_EQ(fa.to_bigint(), a);
+		for (const BigInt& b : this->samples) {
+			TypeParam fb(b);
+			EXPECT_EQ((fa + fb).to_bigint(), (a + b) % mod);
+			EXPECT_EQ((fa - fb).to_bigint(), ((a - b) % mod + mod) % mod);
+			EXPECT_EQ((fa * fb).to_bigint(), (a * b) % mod);
+			EXPECT_EQ((fa / fb).to_bigint(), a / b);
+			EXPECT_EQ((fa % fb).to_bigint(), a % b);
+			EXPECT_EQ(TypeParam::mul_wide(fa, fb).to_bigint(), a * b);
+			EXPECT_EQ(fa < fb, a < b);
+			EXPECT_EQ(fa == fb, a == b);
+		}
+		EXPECT_EQ((fa << 67).to_bigint(), (a * BigInt::pow(BigInt(2), 67)) % mod);
+		EXPECT_EQ((fa >> 67).to_bigint(), a / BigInt::pow(BigInt(2), 67));
+		EXPECT_EQ(fa.bit_length(), a.bit_length());
+	}
+	EXPECT_THROW(TypeParam{mod}, std::out_of_range);
+	EXPECT_THROW(TypeParam{BigInt(-1)}, std::out_of_range);
+	EXPECT_THROW(TypeParam(1) / TypeParam(0), std::runtime_error);
+}
+
+TEST(FixedBigIntConstexpr, EvaluatesAtCompileTime) {
+	constexpr FixedBigInt<256> max = FixedBigInt<256>(0) - FixedBigInt<256>(1);
+	static_assert(max + FixedBigInt<256>(1) == FixedBigInt<256>(0));
+	static_assert(max.bit_length() == 256);
+	static_assert((FixedBigInt<128>(1) << 100) / (FixedBigInt<128>(1) << 40) == (FixedBigInt<128>(1) << 60));
+	static_assert(FixedBigInt<128>::mul_wide(FixedBigInt<128>(1) << 127, FixedBigInt<128>(4)) ==
+	              (FixedBigInt<256>(1) << 129));
+	std::ostringstream os;
+	os << (FixedBigInt<128>(1) << 64);
+	EXPECT_EQ(os.str(), "18446744073709551616");
+}
+
+TEST_F(BigIntTest, Stats) {
+	BigInt::reset_stats();
+	BigInt a("123456789012345678901234567890");
+	BigInt b = a * a + a;
+	BigInt c = b / a;
+	std::ostringstream os;
+	os << c;
+	BigIntStats stats = BigInt::stats();
+#ifdef BIGINT_ENABLE_STATS
+	EXPECT_EQ(stats.calls[BigIntStats::Multiply], 1u);
+	EXPECT_EQ(stats.calls[BigIntStats::Divide], 1u);
+	EXPECT_EQ(stats.calls[BigIntStats::ToString], 1u);
+	EXPECT_GE(stats.calls[BigIntStats::Add], 1u);
+	EXPECT_EQ(stats.algorithmCalls[BigIntStats::Schoolbook][BigIntStats::bucket(4, BigIntStats::SIZE_BUCKETS)], 1u);
+	EXPECT_GT(stats.allocations, 0u);
+	EXPECT_GE(stats.allocatedBytes, stats.allocations * sizeof(unsigned long long));
+	uint64_t sampled = 0;
+	for (uint64_t count : stats.latency[BigIntStats::Multiply]) {
+		sampled += count;
+	}
+	EXPECT_EQ(sampled, 1u);
+	BigInt::reset_stats();
+	EXPECT_EQ(BigInt::stats().calls[BigIntStats::Multiply], 0u);
+#else
+	EXPECT_EQ(stats.calls[BigIntStats::Multiply], 0u);
+	EXPECT_EQ(stats.allocations, 0u);
+#endif
+	EXPECT_STREQ(BigIntStats::operation_name(BigIntStats::ModExp), "modexp");
+	EXPECT_STREQ(BigIntStats::algorithm_name(BigIntStats::Karatsuba), "karatsuba");
+	EXPECT_EQ(BigIntStats::bucket(0, 8), 0u);
+	EXPECT_EQ(BigIntStats::bucket(1000, 8), 7u);
+}
+
+TEST_F(BigIntTest, BigFloatArithmetic) {
+	EXPECT_EQ(BigFloat("1.5") + BigFloat("2.25"), BigFloat("3.75"));
+	EXPECT_EQ(BigFloat("1.5") - BigFloat("2.25"), BigFloat("-0.75"));
+	EXPECT_EQ(BigFloat("1.5") * BigFloat("-2.25"), BigFloat("-3.375"));
+	EXPECT_EQ(BigFloat("1e100") / BigFloat("4e-3"), BigFloat("2.5e102"));
+	EXPECT_LT(BigFloat("-1e5"), BigFloat("1e-5"));
+	EXPECT_GT(BigFloat("12.5"), BigFloat("1.25e1") - BigFloat("1e-40"));
+
+	BigFloat third = BigFloat(1, 5) / BigFloat(3, 5);
+	EXPECT_EQ(third.mantissa(), BigInt(33333));
+	EXPECT_EQ(third.exponent(), -5);
+	EXPECT_EQ((BigFloat(2, 5) / BigFloat(3, 5)).mantissa(), BigInt(66667));
+
+	EXPECT_EQ(BigFloat("1.25", 2), BigFloat("1.2"));
+	EXPECT_EQ(BigFloat("1.35", 2), BigFloat("1.4"));
+	EXPECT_EQ(BigFloat("-1.2500001", 2), BigFloat("-1.3"));
+	EXPECT_EQ(BigFloat::add(BigFloat("1.25"), BigFloat("1e-60"), 2), BigFloat("1.3"));
+	EXPECT_EQ(BigFloat::sub(BigFloat("1.25"), BigFloat("1e-60"), 2), BigFloat("1.2"));
+	EXPECT_EQ(BigFloat::add(BigFloat("9.99"), BigFloat("0.01"), 2).to_string(), "1e1");
+
+	EXPECT_EQ(BigFloat::sqrt(BigFloat(2, 50)).to_string(), "1.4142135623730950488016887242096980785696718753769e0");
+	EXPECT_EQ(BigFloat::sqrt(BigFloat("1.44e-6", 10)), BigFloat("1.2e-3"));
+	EXPECT_EQ(BigFloat::reciprocal(BigFloat(8), 10), BigFloat("0.125"));
+	EXPECT_EQ(BigFloat("-123.999").to_bigint(), BigInt(-123));
+	EXPECT_THROW(BigFloat(1) / BigFloat(0), std::runtime_error);
+	EXPECT_THROW(BigFloat::sqrt(BigFloat(-1)), std::invalid_argument);
+	EXPECT_THROW(BigFloat("1.2.3"), std::invalid_argument);
+}
+
+TEST_F(BigIntTest, BigFloatNewton) {
+	const size_t precision = BigFloat::NEWTON_THRESHOLD + 5;
+	BigInt power = BigInt::pow(ten, precision);
+
+	BigFloat seventh = BigFloat(1, precision) / BigFloat(7, precision);
+	BigInt rem = power % BigInt(7);
+	BigInt expected = power / BigInt(7) + (rem + rem > BigInt(7) ? one : zero);
+	EXPECT_EQ(seventh.mantissa(), expected);
+	EXPECT_EQ(seventh.exponent(), -static_cast<long long>(precision));
+
+	BigFloat root = BigFloat::sqrt(BigFloat(2, precision));
+	ASSERT_EQ(root.exponent(), 1 - static_cast<long long>(precision));
+	BigInt doubled = root.mantissa() + root.mantissa();
+	BigInt target = BigInt(8) * BigInt::pow(ten, 2 * (precision - 1));
+	EXPECT_LT((doubled - one) * (doubled - one), target);
+	EXPECT_GT((doubled + one) * (doubled + one), target);
+
+	BigFloat big("3.14159265358979323846264338327950288419716939937510", precision);
+	EXPECT_EQ(big / big, BigFloat(1, precision));
+	EXPECT_EQ(BigFloat::sqrt(big * big), big);
+}
+
+TEST_F(BigIntTest, BinarySplittingSeries) {
+	EXPECT_EQ(HypergeometricSeries::pi(100),
+	          BigFloat("3.141592653589793238462643383279502884197169399375105820974944592307816406286208998628034825342117068", 100));
+	EXPECT_EQ(HypergeometricSeries::e(100),
+	          BigFloat("2.718281828459045235360287471352662497757247093699959574966967627724076630353547594571382178525166427", 100));
+	EXPECT_EQ(HypergeometricSeries::pi(20).to_string(), "3.1415926535897932385e0");
+
+	HypergeometricSeries::Split whole = HypergeometricSeries::euler().split(0, 10);
+	HypergeometricSeries::Split naive{one, one, zero};
+	for (int k = 0; k < 10; ++k) {
+		naive.q *= BigInt(k == 0 ? 1 : k);
+		naive.t = naive.t * BigInt(k == 0 ? 1 : k) + one;
+	}
+	EXPECT_EQ(whole.q, naive.q);
+	EXPECT_EQ(whole.t, naive.t);
+	EXPECT_THROW(HypergeometricSeries::euler().split(3, 3), std::invalid_argument);
+}
+
+TEST_F(BigIntTest, PreparedMultiplier) {
+	std::string digits1, digits2;
+	for (int i = 0; i < 5000; ++i) {
+		digits1 += static_cast<char>('1' + (i * 7) % 9);
+		digits2 += static_cast<char>('9' - (i * 5) % 9);
+	}
+	BigInt a(digits1);
+	BigInt b(digits2);
+	EXPECT_EQ(BigInt::fftMultiply(a, b), a * b);
+
+	PreparedMultiplier prepared(a);
+	EXPECT_EQ(prepared.operand(), a);
+	EXPECT_EQ(prepared.multiply(b), a * b);
+	EXPECT_EQ(prepared.multiply(zero - b), zero - a * b);
+	EXPECT_EQ(prepared.multiply(zero), zero);
+	for (int len : {1, 9, 10, 400, 4999}) {
+		BigInt other(digits2.substr(0, len));
+		EXPECT_EQ(prepared.multiply(other), a * other);
+		EXPECT_EQ(prepared.multiply(other), a * other);
+	}
+	EXPECT_EQ(PreparedMultiplier(neg_small).multiply(neg_small), neg_small * neg_small);
+}
+
+TEST_F(BigIntTest, FFTLarge) {
+	std::string digits1, digits2;
+	for (int i = 0; i < 60000; ++i) {
+		digits1 += static_cast<char>('9' - (i * 3) % 7);
+		digits2 += static_cast<char>('9' - (i % 11 == 0));
+	}
+	BigInt a(digits1);
+	BigInt b(digits2);
+	BigInt expected = BigInt::karatsuba(a, b);
+	EXPECT_EQ(BigInt::fftMultiply(a, b), expected);
+	EXPECT_EQ(a * b, expected);
+	EXPECT_EQ(BigInt::fftMultiply(zero - a, BigInt(digits2.substr(0, 7000))),
+	          zero - BigInt::karatsuba(a, BigInt(digits2.substr(0, 7000))));
+	EXPECT_EQ((a * b) / b, a);
+}
+
+TEST_F(BigIntTest, OutOfCoreMultiply) {
+	std::string dir = std::filesystem::temp_directory_path().string() + "/bigint_ooc_" + std::to_string(getpid());
+	std::filesystem::create_directories(dir);
+	std::string digits1, digits2;
+	for (int i = 0; i < 40000; ++i) {
+		digits1 += static_cast<char>('9' - (i * 3) % 7);
+		digits2 += static_cast<char>('1' + (i * 5) % 9);
+	}
+	BigInt a(digits1);
+	BigInt b(digits2.substr(0, 23456));
+	OutOfCoreMultiplier::save(a, dir + "/a");
+	OutOfCoreMultiplier::save(b, dir + "/b");
+	OutOfCoreMultiplier::save(zero, dir + "/zero");
+	EXPECT_EQ(OutOfCoreMultiplier::load(dir + "/a"), a);
+
+	for (size_t block : {size_t{300}, size_t{700}, size_t{4096}, OutOfCoreMultiplier::DEFAULT_BLOCK_LIMBS}) {
+		OutOfCoreMultiplier(block).multiply(dir + "/a", dir + "/b", dir + "/out");
+		EXPECT_EQ(OutOfCoreMultiplier::load(dir + "/out"), a * b);
+	}
+	OutOfCoreMultiplier(512).multiply(dir + "/b", dir + "/a", dir + "/out");
+	EXPECT_EQ(OutOfCoreMultiplier::load(dir + "/out"), a * b);
+	OutOfCoreMultiplier(512).multiply(dir + "/a", dir + "/zero", dir + "/out");
+	EXPECT_EQ(OutOfCoreMultiplier::load(dir + "/out"), zero);
+	BigInt nines(std::string(27000, '9'));
+	OutOfCoreMultiplier::save(nines, dir + "/nines");
+	OutOfCoreMultiplier(100).multiply(dir + "/nines", dir + "/nines", dir + "/out");
+	EXPECT_EQ(OutOfCoreMultiplier::load(dir + "/out"), nines * nines);
+	EXPECT_THROW(OutOfCoreMultiplier(512).multiply(dir + "/a", dir + "/b", dir + "/b"), std::invalid_argument);
+	EXPECT_EQ(OutOfCoreMultiplier::load(dir + "/b"), b);
+	EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()), 5);
+
+	EXPECT_THROW(OutOfCoreMultiplier::save(neg_small, dir + "/neg"), std::invalid_argument);
+	EXPECT_THROW(OutOfCoreMultiplier::load(dir + "/missing"), std::system_error);
+	EXPECT_THROW(OutOfCoreMultiplier(0), std::invalid_argument);
+	std::filesystem::remove_all(dir);
+}
+
+TEST_F(BigIntTest, AsyncOperations) {
+	AsyncBigInt pool(2);
+	BigInt mod("170141183460469231731687303715884105727");
+	BigInt a("98765432109876543210987654321098765432");
+	AsyncOperation<BigInt> product = pool.multiply(a, mod);
+	AsyncOperation<BigInt> quotient = pool.divide(a * mod + base_val, mod);
+	AsyncOperation<BigInt> power = pool.mod_exp(a, mod - one, mod);
+	AsyncOperation<std::string> str = pool.to_string(neg_small);
+	EXPECT_EQ(product.get(), a * mod);
+	EXPECT_EQ(quotient.get(), a);
+	EXPECT_EQ(power.get(), one);
+	EXPECT_EQ(str.get(), "-123");
+	EXPECT_EQ(product.progress(), 1.0);
+	EXPECT_THROW(pool.divide(a, zero).get(), std::runtime_error);
+
+	CancellationToken token;
+	token.cancel();
+	EXPECT_THROW(pool.multiply(a, a, token).get(), OperationCancelled);
+
+	std::string digits(20000, '7');
+	BigInt big(digits);
+	AsyncOperation<BigInt> slow = pool.mod_exp(big, big, big + one);
+	while (slow.progress() == 0 && !slow.ready()) {
+		std::this_thread::yield();
+	}
+	slow.cancel();
+	EXPECT_THROW(slow.get(), OperationCancelled);
+}
+
+TEST_F(BigIntTest, OperationContextCheckpoints) {
+	std::string digits(9000, '3');
+	BigInt big(digits);
+	BigInt divisor(digits.substr(0, 4000));
+	BigInt product = big * divisor;
+	BigInt copy = big;
+
+	OperationContext context;
+	{
+		OperationContext::Activation activation(context);
+		EXPECT_EQ(product / divisor, big);
+		EXPECT_GT(context.progress(), 0.9);
+		context.token().cancel();
+		EXPECT_THROW(big *= big, OperationCancelled);
+		EXPECT_THROW(product / divisor, OperationCancelled);
+	}
+	EXPECT_EQ(big, copy);
+	EXPECT_EQ(big * one, copy);
+}
+
+TEST_F(BigIntTest, BigIntArray) {
+	std::vector<BigInt> left = {pos_small, neg_small, zero, base_val, BigInt("-99999999999999999999"), BigInt("5"),
+	                            BigInt("-1000000000")};
+	std::vector<BigInt> right = {neg_small, neg_small, BigInt(7), one, BigInt("99999999999999999999"), BigInt("-8"),
+	                             BigInt("1")};
+	BigIntArray a(left);
+	BigIntArray b(right);
+	ASSERT_EQ(a.size(), left.size());
+	EXPECT_EQ(a.to_vector(), left);
+	EXPECT_EQ(a[3].to_bigint(), base_val);
+	EXPECT_TRUE(a[1].negative());
+	EXPECT_THROW(a.get(left.size()), std::out_of_range);
+
+	BigIntArray sum = BigIntArray::add(a, b);
+	std::vector<int> order = BigIntArray::compare(a, b);
+	for (size_t i = 0; i < left.size(); ++i) {
+		EXPECT_EQ(sum.get(i), left[i] + right[i]);
+		EXPECT_EQ(order[i], left[i] < right[i] ? -1 : (left[i] > right[i] ? 1 : 0));
+	}
+	EXPECT_EQ(sum[4].limbs().size(), 1u);
+	EXPECT_FALSE(sum[4].negative());
+
+	std::vector<BigInt> sorted = left;
+	sorted.insert(sorted.end(), right.begin(), right.end());
+	BigIntArray all(sorted);
+	all.sort();
+	std::sort(sorted.begin(), sorted.end());
+	EXPECT_EQ(all.to_vector(), sorted);
+	EXPECT_THROW(BigIntArray::add(a, all), std::invalid_argument);
+}
+
+TEST(MpnKernels, MatchBigIntArithmetic) {
+	std::string original = Mpn::implementation();
+	std::mt19937_64 engine(41);
+	auto to_bigint = [](const std::vector<Mpn::limb>& limbs, Mpn::limb top) {
+		BigInt value(static_cast<long long>(top));
+		for (size_t i = limbs.size(); i-- > 0;) {
+			value = value * BigInt(static_cast<long long>(Mpn::BASE)) + BigInt(static_cast<long long>(limbs[i]));
+		}
+		return value;
+	};
+	for (std::string name : {"generic", "bmi2", "avx2", "avx512"}) {
+		if (!Mpn::use_implementation(name)) {
+			continue;
+		}
+		EXPECT_EQ(Mpn::implementation(), name);
+		for (size_t n : {1, 2, 7, 64}) {
+			std::vector<Mpn::limb> a(n), b(n), r(n);
+			for (size_t i = 0; i < n; ++i) {
+				a[i] = i == n - 1 ? Mpn::BASE - 1 : engine() % Mpn::BASE;
+				b[i] = engine() % Mpn::BASE;
+			}
+			BigInt va = to_bigint(a, 0);
+			BigInt vb = to_bigint(b, 0);
+			BigInt shift = BigInt::pow(BigInt(static_cast<long long>(Mpn::BASE)), n);
+			Mpn::limb factor = engine() % Mpn::BASE;
+			BigInt vf(static_cast<long long>(factor));
+
+			Mpn::limb top = Mpn::add_n(r.data(), a.data(), b.data(), n);
+			EXPECT_EQ(to_bigint(r, top), va + vb);
+			top = Mpn::sub_n(r.data(), a.data(), b.data(), n);
+			EXPECT_EQ(to_bigint(r, 0), va - vb + BigInt(static_cast<long long>(top)) * shift);
+			top = Mpn::mul_1(r.data(), a.data(), n, factor);
+			EXPECT_EQ(to_bigint(r, top), va * vf);
+			r = b;
+			top = Mpn::addmul_1(r.data(), a.data(), n, factor);
+			EXPECT_EQ(to_bigint(r, top), vb + va * vf);
+			r = b;
+			top = Mpn::submul_1(r.data(), a.data(), n, factor);
+			EXPECT_EQ(to_bigint(r, 0) - BigInt(static_cast<long long>(top)) * shift, vb - va * vf);
+			top = Mpn::add_1(r.data(), a.data(), n, Mpn::BASE - 1);
+			EXPECT_EQ(to_bigint(r, top), va + BigInt(static_cast<long long>(Mpn::BASE - 1)));
+			top = Mpn::sub_1(r.data(), b.data(), n, 1);
+			EXPECT_EQ(to_bigint(r, 0) - BigInt(static_cast<long long>(top)) * shift, vb - BigInt(1));
+
+			std::vector<Mpn::limb> wide(n + 19), acc(2 * n + 19);
+			for (Mpn::limb& limb : wide) {
+				limb = engine() % Mpn::BASE;
+			}
+			for (Mpn::limb& limb : acc) {
+				limb = Mpn::BASE - 1 - engine() % 2;
+			}
+			BigInt vacc = to_bigint(acc, 0);
+			top = Mpn::addmul_rows(acc.data(), a.data(), n, wide.data(), wide.size());
+			EXPECT_EQ(to_bigint(acc, top), vacc + va * to_bigint(wide, 0));
+		}
+		std::vector<Mpn::limb> nines(37, Mpn::BASE - 1), square(74, 0);
+		EXPECT_EQ(Mpn::addmul_rows(square.data(), nines.data(), 37, nines.data(), 37), 0u);
+		BigInt all_nines = BigInt::pow(BigInt(10), 333) - BigInt(1);
+		EXPECT_EQ(to_bigint(square, 0), all_nines * all_nines);
+		BigInt big = BigInt::factorial(500);
+		EXPECT_EQ((big * (big + BigInt(1))) / big, big + BigInt(1));
+	}
+	EXPECT_FALSE(Mpn::use_implementation("sse9"));
+	Mpn::use_implementation(original);
+}
+
+TEST(BigIntAccumulator, MatchesEagerArithmetic) {
+	std::mt19937_64 engine(43);
+	auto random_value = [&](size_t limbs) {
+		std::string str = std::to_string(1 + engine() % 9);
+		for (size_t i = 1; i < limbs * 9; ++i) {
+			str += static_cast<char>('0' + engine() % 10);
+		}
+		BigInt value(str);
+		return engine() % 2 ? BigInt(0) - value : value;
+	};
+
+	BigIntAccumulator acc;
+	BigInt expected;
+	EXPECT_EQ(acc.value(), BigInt(0));
+	for (int i = 0; i < 400; ++i) {
+		BigInt a = random_value(1 + engine() % 12);
+		BigInt b = random_value(1 + engine() % 12);
+		long long factor = static_cast<long long>(engine());
+		switch (i % 5) {
+			case 0:
+				acc += a;
+				expected += a;
+				break;
+			case 1:
+				acc -= a;
+				expected -= a;
+				break;
+			case 2:
+				acc.addmul(a, b);
+				expected += a * b;
+				break;
+			case 3:
+				acc.submul(a, b);
+				expected -= a * b;
+				break;
+			default:
+				acc.addmul(a, factor);
+				expected += a * BigInt(factor);
+				break;
+		}
+		if (i % 37 == 0) {
+			EXPECT_EQ(acc.value(), expected);
+		}
+	}
+	EXPECT_EQ(acc.value(), expected);
+
+	acc -= expected;
+	EXPECT_EQ(acc.value(), BigInt(0));
+	acc -= BigInt(1);
+	EXPECT_EQ(acc.value(), BigInt(-1));
+	acc.addmul(BigInt(7), std::numeric_limits<long long>::min());
+	EXPECT_EQ(acc.value(), BigInt(-1) + BigInt(7) * BigInt("-9223372036854775808"));
+
+	std::vector<BigInt> xs, ys;
+	BigInt dot;
+	for (int i = 0; i < 50; ++i) {
+		xs.push_back(random_value(i == 7 ? 200 : 1 + i % 6));
+		ys.push_back(random_value(i == 7 ? 150 : 1 + i % 4));
+		dot += xs.back() * ys.back();
+	}
+	EXPECT_EQ(BigIntAccumulator::dot(xs, ys), dot);
+	EXPECT_EQ(BigIntAccumulator::sum(xs), std::accumulate(xs.begin(), xs.end(), BigInt(0)));
+	ys.pop_back();
+	EXPECT_THROW(BigIntAccumulator::dot(xs, ys), std::invalid_argument);
+	acc.clear();
+	EXPECT_EQ(acc.value(), BigInt(0));
+}
+
+TEST(Rns, RoundTripAndArithmetic) {
+	std::mt19937_64 engine(44);
+	auto random_value = [&](size_t digits) {
+		std::string str = std::to_string(1 + engine() % 9);
+		for (size_t i = 1; i < digits; ++i) {
+			str += static_cast<char>('0' + engine() % 10);
+		}
+		BigInt value(str);
+		return engine() % 2 ? BigInt(0) - value : value;
+	};
+
+	auto basis = std::make_shared<const RnsBasis>(2000);
+	EXPECT_GE(basis->bits(), 2000u);
+	EXPECT_EQ(basis->primes().size(), basis->size());
+	EXPECT_EQ(BigInt::product(std::vector<BigInt>(basis->primes().begin(), basis->primes().end())), basis->modulus());
+
+	for (BigInt value : {BigInt(0), BigInt(1), BigInt(-1), BigInt(2147483647), BigInt(-2147483647),
+	                     BigInt::pow(BigInt(2), 1999), BigInt(0) - BigInt::pow(BigInt(2), 1999)}) {
+		EXPECT_EQ(RnsInt(basis, value).to_bigint(), value);
+	}
+
+	// Mixed expression whose intermediate terms stay below 2^2000 in magnitude.
+	std::vector<BigInt> xs, ys;
+	for (int i = 0; i < 37; ++i) {
+		xs.push_back(random_value(1 + engine() % 280));
+		ys.push_back(random_value(1 + engine() % 280));
+	}
+	BigInt expected;
+	RnsInt acc(basis, BigInt(0));
+	for (size_t i = 0; i < xs.size(); ++i) {
+		RnsInt x(basis, xs[i]);
+		RnsInt y(basis, ys[i]);
+		if (i % 3 == 2) {
+			acc -= x * y;
+			expected -= xs[i] * ys[i];
+		} else {
+			acc += x * y + x - y;
+			expected += xs[i] * ys[i] + xs[i] - ys[i];
+		}
+	}
+	EXPECT_EQ(acc.to_bigint(), expected);
+
+	// Out of range values wrap modulo M.
+	BigInt big = basis->modulus() + BigInt(5);
+	EXPECT_EQ(RnsInt(basis, big).to_bigint(), BigInt(5));
+
+	auto other = std::make_shared<const RnsBasis>(2000);
+	EXPECT_THROW(RnsInt(basis, BigInt(1)) + RnsInt(other, BigInt(1)), std::invalid_argument);
+}
+
+TEST(Expression, Evaluate) {
+	EXPECT_EQ(Expression::evaluate("1 + 2 * 3"), BigInt(7));
+	EXPECT_EQ(Expression::evaluate("(1 + 2) * 3"), BigInt(9));
+	EXPECT_EQ(Expression::evaluate("-2^3 - -4"), BigInt(-4));
+	EXPECT_EQ(Expression::evaluate("2^3^2"), BigInt(512));
+	EXPECT_EQ(Expression::evaluate("17 / 5 * 5 + 17 % 5"), BigInt(17));
+	EXPECT_EQ(Expression::evaluate("pow(10, 30) - 1"), BigInt("999999999999999999999999999999"));
+	EXPECT_EQ(Expression::evaluate("modexp(4, 13, 497)"), BigInt(445));
+	EXPECT_EQ(Expression::evaluate(" gcd(2^40 * 3, 6^20) "), BigInt::pow(BigInt(2), 20) * BigInt(3));
+	EXPECT_EQ(Expression::evaluate("(-1)^(10^30 + 1)"), BigInt(-1));
+	EXPECT_EQ(Expression::evaluate("123456789123456789123456789 * 987654321987654321"),
+	          BigInt("123456789123456789123456789") * BigInt("987654321987654321"));
+
+	std::string nested(1000, '(');
+	for (const char* bad : {"", "1 +", "(1", "1)", "2 ** 3", "foo(1, 2)", "gcd(1)", "2^-1", "modexp(2, -1, 5)",
+	                        "1 2", nested.c_str()}) {
+		EXPECT_THROW(Expression::evaluate(bad), std::invalid_argument) << bad;
+	}
+	EXPECT_THROW(Expression::evaluate("1 / 0"), std::runtime_error);
+	EXPECT_THROW(Expression::evaluate("3^100000", 1000), std::length_error);
+	EXPECT_THROW(Expression::evaluate("2^(10^30)"), std::length_error);
+	EXPECT_EQ(Expression::evaluate("3^100", 1000), BigInt::pow(BigInt(3), 100));
+}
+
+TEST(BigIntServer, ServesClients) {
+	BigIntServer::Options options;
+	options.path = "/tmp/bigint_server_test_" + std::to_string(::getpid()) + ".sock";
+	options.threads = 2;
+	options.batch = 8;
+	options.contexts = 2;
+	{
+		// A socket file left by a server that is gone is taken over.
+		int stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		std::strcpy(address.sun_path, options.path.c_str());
+		ASSERT_EQ(::bind(stale, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+		::close(stale);
+	}
+	BigIntServer server(options);
+	server.start();
+	BigIntServer rival(options);
+	EXPECT_THROW(rival.start(), std::system_error);
+	{
+		BigIntServer::Options file_options = options;
+		file_options.path += ".txt";
+		std::ofstream(file_options.path) << "keep";
+		BigIntServer misdirected(file_options);
+		EXPECT_THROW(misdirected.start(), std::system_error);
+		EXPECT_TRUE(std::filesystem::exists(file_options.path));
+		std::filesystem::remove(file_options.path);
+	}
+	{
+		BigIntClient client(options.path);
+		BigInt a("123456789012345678901234567890123456789");
+		BigInt b("-987654321098765432109876543210");
+		BigInt m("170141183460469231731687303715884105727");
+		EXPECT_EQ(client.add(a, b), a + b);
+		EXPECT_EQ(client.sub(a, b), a - b);
+		EXPECT_EQ(client.mul(a, b), a * b);
+		EXPECT_EQ(client.div(a, b), a / b);
+		EXPECT_EQ(client.mod(a, b), a % b);
+		EXPECT_EQ(client.gcd(a * BigInt(6), BigInt(36)), BigInt(18));
+		EXPECT_EQ(client.mod_mul(a, a, m), a * a % m);
+		BarrettContext reference(m);
+		EXPECT_EQ(client.mod_exp(a, BigInt(65537), m), reference.pow(a, BigInt(65537)));
+		EXPECT_THROW(client.div(a, BigInt(0)), std::runtime_error);
+		EXPECT_THROW(client.mod_exp(a, BigInt(-1), m), std::runtime_error);
+
+		// Larger than the client's send window, with failures mixed in.
+		std::vector<BigIntClient::Call> calls;
+		for (int i = 0; i < 600; ++i) {
+			BigInt x = a + BigInt(i);
+			if (i % 3 == 0) {
+				calls.push_back({BigIntProtocol::Divide, {x, BigInt(0)}});
+			} else if (i % 3 == 1) {
+				calls.push_back({BigIntProtocol::ModExp, {x, BigInt(i), m}});
+			} else {
+				calls.push_back({BigIntProtocol::Multiply, {x, BigInt(i)}});
+			}
+		}
+		calls.push_back({BigIntProtocol::ModMul, {a, b}});
+		std::vector<BigIntClient::Result> results = client.execute(calls);
+		ASSERT_EQ(results.size(), calls.size());
+		for (int i = 0; i < 600; ++i) {
+			BigInt x = a + BigInt(i);
+			EXPECT_EQ(results[i].ok, i % 3 != 0) << i;
+			if (i % 3 == 0) {
+				EXPECT_EQ(results[i].error, "Division by zero");
+			} else if (i % 3 == 1) {
+				EXPECT_EQ(results[i].value, reference.pow(x, BigInt(i))) << i;
+			} else {
+				EXPECT_EQ(results[i].value, x * BigInt(i)) << i;
+			}
+		}
+		EXPECT_FALSE(results.back().ok);
+		EXPECT_EQ(client.add(a, a), a + a);
+
+		BigIntClient other(options.path);
+		EXPECT_EQ(other.mod_mul(b, b, m), b * b % m);
+		std::string stats = client.stats();
+		EXPECT_NE(stats.find("mul      count=201 errors=0"), std::string::npos) << stats;
+		EXPECT_NE(stats.find("div      count=202 errors=201"), std::string::npos) << stats;
+	}
+	EXPECT_THROW(BigIntClient(options.path + ".missing"), std::system_error);
+	server.stop();
+	EXPECT_FALSE(std::filesystem::exists(options.path));
+}
+
+TEST(BigIntRandom, UniformAndReproducible) {
+	std::mt19937_64 engine(47);
+	std::mt19937_64 replay(47);
+	for (const char* text : {"1", "2", "7", "999999999", "1000000000", "1000000001", "1000000000000000000",
+	                         "1000000000000000001", "123456789012345678901234567890", "999999999999999999999999999999"}) {
+		BigInt bound(text);
+		for (int i = 0; i < 200; ++i) {
+			BigInt value = BigInt::random_below(bound, engine);
+			EXPECT_GE(value, BigInt(0));
+			EXPECT_LT(value, bound) << text;
+			EXPECT_EQ(value, BigInt::random_below(bound, replay));
+		}
+	}
+	EXPECT_THROW(BigInt::random_below(BigInt(0), engine), std::invalid_argument);
+	EXPECT_THROW(BigInt::random_below(BigInt(-5), engine), std::invalid_argument);
+
+	EXPECT_EQ(BigInt::random_bits(0, engine), BigInt(0));
+	size_t widest = 0;
+	for (int i = 0; i < 200; ++i) {
+		BigInt value = BigInt::random_bits(200, engine);
+		EXPECT_LE(value.bit_length(), 200u);
+		widest = std::max(widest, value.bit_length());
+	}
+	EXPECT_GE(widest, 195u);
+
+	// A 32-bit engine works too, and the draws fall evenly across the limb boundary.
+	std::minstd_rand small(3);
+	BigInt bound("3000000000");
+	int counts[3] = {0, 0, 0};
+	for (int i = 0; i < 3000; ++i) {
+		BigInt value = BigInt::random_below(bound, small);
+		ASSERT_LT(value, bound);
+		++counts[value < BigInt(1000000000) ? 0 : value < BigInt(2000000000) ? 1 : 2];
+	}
+	for (int count : counts) {
+		EXPECT_GT(count, 850);
+		EXPECT_LT(count, 1150);
+	}
+}
+
+TEST(BigIntConversion, DoubleAndFixedWidth) {
+	EXPECT_EQ(BigInt(std::numeric_limits<long long>::min()), BigInt("-9223372036854775808"));
+	EXPECT_EQ(BigInt(std::numeric_limits<long long>::max()), BigInt("9223372036854775807"));
+
+	const BigInt::uint128 umax = ~BigInt::uint128(0);
+	const BigInt::int128 imin = -static_cast<BigInt::int128>(umax >> 1) - 1;
+	EXPECT_EQ(BigInt(umax), BigInt("340282366920938463463374607431768211455"));
+	EXPECT_EQ(BigInt(imin), BigInt("-170141183460469231731687303715884105728"));
+	EXPECT_TRUE(BigInt(imin).to_int128() == imin);
+	EXPECT_TRUE(BigInt("-12345678901234567890123").to_int128() ==
+	            -static_cast<BigInt::int128>(12345678901234567890ULL) * 1000 - 123);
+	EXPECT_THROW(BigInt("170141183460469231731687303715884105728").to_int128(), std::out_of_range);
+	EXPECT_EQ(BigInt("-9223372036854775808").to_int64(), std::numeric_limits<long long>::min());
+	EXPECT_EQ(BigInt(-42).to_int64(), -42);
+	EXPECT_THROW(BigInt("9223372036854775808").to_int64(), std::out_of_range);
+
+	EXPECT_TRUE(BigInt(255).fits<unsigned char>());
+	EXPECT_FALSE(BigInt(256).fits<unsigned char>());
+	EXPECT_TRUE(BigInt(-128).fits<signed char>());
+	EXPECT_FALSE(BigInt(-129).fits<signed char>());
+	EXPECT_FALSE(BigInt(-1).fits<unsigned long long>());
+	EXPECT_TRUE(BigInt("18446744073709551615").fits<unsigned long long>());
+	EXPECT_FALSE(BigInt("18446744073709551616").fits<unsigned long long>());
+	EXPECT_TRUE(BigInt(umax).fits<BigInt::uint128>());
+	EXPECT_FALSE((BigInt(umax) + BigInt(1)).fits<BigInt::uint128>());
+	EXPECT_FALSE(BigInt(umax).fits<BigInt::int128>());
+	EXPECT_TRUE(BigInt(imin).fits<BigInt::int128>());
+	EXPECT_FALSE(BigInt::pow(BigInt(10), 60).fits<BigInt::uint128>());
+
+	EXPECT_EQ(BigInt(-2.75), BigInt(-2));
+	EXPECT_EQ(BigInt(-0.0), BigInt(0));
+	EXPECT_EQ(BigInt(0x1p100), BigInt::pow(BigInt(2), 100));
+	EXPECT_EQ(BigInt(-0x1.8p200), BigInt(-3) * BigInt::pow(BigInt(2), 199));
+	EXPECT_THROW(BigInt(std::numeric_limits<double>::quiet_NaN()), std::invalid_argument);
+	EXPECT_THROW(BigInt(-std::numeric_limits<double>::infinity()), std::invalid_argument);
+
+	// Exact midpoints between neighbouring doubles round to even; one past them rounds away.
+	const BigInt two53 = BigInt::pow(BigInt(2), 53);
+	for (unsigned long long shift : {0ULL, 200ULL, 970ULL}) {
+		BigInt scale = BigInt::pow(BigInt(2), shift);
+		BigInt even_tie = (two53 + BigInt(1)) * scale;
+		BigInt odd_tie = (two53 + BigInt(3)) * scale;
+		EXPECT_EQ(even_tie.to_double(), std::ldexp(0x1p53, static_cast<int>(shift)));
+		EXPECT_EQ(odd_tie.to_double(), std::ldexp(0x1p53 + 4, static_cast<int>(shift)));
+		EXPECT_EQ((even_tie + BigInt(1)).to_double(), std::ldexp(0x1p53 + 2, static_cast<int>(shift)));
+		EXPECT_EQ((odd_tie - BigInt(1)).to_double(), std::ldexp(0x1p53 + 2, static_cast<int>(shift)));
+	}
+	const BigInt largest(std::numeric_limits<double>::max());
+	const BigInt overflow_tie = largest + BigInt::pow(BigInt(2), 970);
+	EXPECT_EQ(largest.to_double(), std::numeric_limits<double>::max());
+	EXPECT_EQ((overflow_tie - BigInt(1)).to_double(), std::numeric_limits<double>::max());
+	EXPECT_EQ(overflow_tie.to_double(), HUGE_VAL);
+	EXPECT_EQ((BigInt(0) - BigInt::pow(BigInt(10), 5000)).to_double(), -HUGE_VAL);
+
+	// strtod rounds correctly, so it is the reference for arbitrary decimal strings.
+	std::mt19937_64 engine(48);
+	for (int i = 0; i < 2000; ++i) {
+		std::string text(1 + engine() % 330, '0');
+		text[0] = static_cast<char>('1' + engine() % 9);
+		for (size_t j = 1; j < text.size(); ++j) {
+			text[j] = static_cast<char>('0' + engine() % 10);
+		}
+		EXPECT_EQ(BigInt(text).to_double(), std::strtod(text.c_str(), nullptr)) << text;
+		double value = std::ldexp(static_cast<double>(engine() >> 11), static_cast<int>(engine() % 960)) * -1.0;
+		EXPECT_EQ(BigInt(value).to_double(), value);
+	}
+}
+
+TEST(Factorizer, TrialRhoAndEcm) {
+	auto to_bigints = [](std::initializer_list<const char*> texts) {
+		std::vector<BigInt> values;
+		for (const char* text : texts) {
+			values.push_back(BigInt(text));
+		}
+		return values;
+	};
+	EXPECT_TRUE(Factorizer::factor(BigInt(1)).empty());
+	EXPECT_THROW(Factorizer::factor(BigInt(0)), std::invalid_argument);
+	EXPECT_THROW(Factorizer::factor(BigInt(-6)), std::invalid_argument);
+	EXPECT_EQ(Factorizer::factor(BigInt(2)), to_bigints({"2"}));
+	EXPECT_EQ(Factorizer::factor(BigInt(1000000007)), to_bigints({"1000000007"}));
+
+	// Trial division, then a perfect cube of a prime beyond the trial limit.
+	BigInt p12("100000000003");
+	EXPECT_EQ(Factorizer::factor(BigInt(248832) * p12 * p12 * p12),
+	          to_bigints({"2", "2", "2", "2", "2", "2", "2", "2", "2", "2", "3", "3", "3", "3", "3", "100000000003",
+	                      "100000000003", "100000000003"}));
+	// Pollard rho: two 12-15 digit primes.
+	EXPECT_EQ(Factorizer::factor(p12 * BigInt("100000000000031") * BigInt(1000003)),
+	          to_bigints({"1000003", "100000000003", "100000000000031"}));
+	BigInt prime("170141183460469231731687303715884105727");
+	EXPECT_EQ(Factorizer::factor(prime), std::vector<BigInt>{prime});
+
+	// ECM: a 15-digit factor of a 46-digit number, which rho would need ~10^7 steps for. The factor comes from the
+	// lowest-numbered successful curve, so it does not depend on the thread count.
+	BigInt p15("100000000000031");
+	BigInt n = p15 * BigInt("1000000000000000000000000000057");
+	BigInt found_alone, found_shared;
+	ASSERT_TRUE(Factorizer::ecm(n, found_alone, 2000, 4, 1, 5));
+	ASSERT_TRUE(Factorizer::ecm(n, found_shared, 2000, 4, 3, 5));
+	EXPECT_EQ(found_alone, p15);
+	EXPECT_EQ(found_shared, p15);
+	BigInt unused;
+	EXPECT_FALSE(Factorizer::pollard_rho(n, unused, 1000));
+	EXPECT_TRUE(Factorizer::pollard_rho(BigInt(1000000) * BigInt(1000003), unused, 1000));
+	EXPECT_EQ(unused, BigInt(2));
+}
+
+TEST(RsaPrivateKey, CrtMatchesFullModulus) {
+	BigInt p("170141183460469231731687303715884105727");
+	BigInt q("618970019642690137449562111");
+	BigInt e(65537);
+	RsaPrivateKey key = RsaPrivateKey::from_primes(p, q, e);
+	EXPECT_EQ(key.modulus(), p * q);
+
+	std::mt19937_64 engine(5);
+	for (int i = 0; i < 20; ++i) {
+		BigInt message = BigInt::random_below(key.modulus(), engine);
+		BigInt cipher = BigInt::mod_exp(message, e, key.modulus());
+		EXPECT_EQ(key.apply(cipher), message);
+		EXPECT_EQ(key.apply(cipher, true), message);
+	}
+	EXPECT_EQ(key.apply(BigInt(0)), BigInt(0));
+	EXPECT_EQ(key.apply(BigInt(1), true), BigInt(1));
+
+	EXPECT_THROW(key.apply(key.modulus()), std::invalid_argument);
+	EXPECT_THROW(key.apply(BigInt(-1)), std::invalid_argument);
+	EXPECT_THROW(RsaPrivateKey::from_primes(p, p, e), std::invalid_argument);
+	EXPECT_THROW(RsaPrivateKey(p, q, BigInt(1), BigInt(1), BigInt(2)), std::invalid_argument);
+	EXPECT_THROW(RsaPrivateKey(BigInt(2), q, BigInt(1), BigInt(1), BigInt(1)), std::invalid_argument);
+	EXPECT_THROW(RsaPrivateKey(BigInt(0), q, BigInt(1), BigInt(1), BigInt(1)), std::invalid_argument);
+	EXPECT_THROW(RsaPrivateKey(p, BigInt(0), BigInt(1), BigInt(1), BigInt(1)), std::invalid_argument);
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/expression.hpp"
+
+// Evaluates one expression per input line (see expression.hpp for the syntax) and prints one result per line, in
+// input order. Lines are read in batches; a pool of workers evaluates one batch while the main thread prints the
+// previous one and reads the next, so at most two batches are held in memory. A line that fails to parse or
+// evaluate prints "error: <reason>" and makes the exit status 1; blank lines are echoed as blank lines.
+//   bigcalc [--threads N] [--batch N] [--max-bits N] [file]
+
+struct Batch {
+	std::vector<std::string> lines;
+	std::vector<std::string> results;
+	std::vector<unsigned char> failed;
+};
+
+class BatchPool {
+   public:
+	BatchPool(unsigned int threads, size_t max_bits) : maxBits(max_bits) {
+		for (unsigned int i = 0; i < threads; ++i) {
+			workers.emplace_back([this] { run(); });
+		}
+	}
+
+	~BatchPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	void start(Batch& batch) {
+		batch.results.assign(batch.lines.size(), std::string());
+		batch.failed.assign(batch.lines.size(), 0);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			current = &batch;
+			next = 0;
+			busy = workers.size();
+			++generation;
+		}
+		wake.notify_all();
+	}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this] { return busy == 0; });
+	}
+
+   private:
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	Batch* current = nullptr;
+	std::atomic<size_t> next{0};
+	size_t busy = 0;
+	unsigned long long generation = 0;
+	bool stopping = false;
+	size_t maxBits;
+
+	inline static const size_t CHUNK = 16;
+
+	void run() {
+		unsigned long long seen = 0;
+		while (true) {
+			Batch* batch;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [&] { return stopping || generation != seen; });
+				if (stopping) {
+					return;
+				}
+				seen = generation;
+				batch = current;
+			}
+			size_t count = batch->lines.size();
+			for (size_t begin = next.fetch_add(CHUNK); begin < count; begin = next.fetch_add(CHUNK)) {
+				for (size_t i = begin; i < std::min(begin + CHUNK, count); ++i) {
+					evaluate(*batch, i);
+				}
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--busy == 0) {
+				done.notify_one();
+			}
+		}
+	}
+
+	void evaluate(Batch& batch, size_t i) const {
+		const std::string& line = batch.lines[i];
+		if (line.find_first_not_of(" \t\r") == std::string::npos) {
+			return;
+		}
+		try {
+			std::ostringstream out;
+			out << Expression::evaluate(line, maxBits);
+			batch.results[i] = out.str();
+		} catch (const std::exception& e) {
+			batch.results[i] = std::string("error: ") + e.what();
+			batch.failed[i] = 1;
+		}
+	}
+};
+
+static bool readBatch(std::istream& in, Batch& batch, size_t size) {
+	batch.lines.clear();
+	std::string line;
+	while (batch.lines.size() < size && std::getline(in, line)) {
+		batch.lines.push_back(std::move(line));
+	}
+	return !batch.lines.empty();
+}
+
+static bool writeBatch(std::ostream& out, const Batch& batch) {
+	bool ok = true;
+	for (size_t i = 0; i < batch.results.size(); ++i) {
+		out << batch.results[i] << '\n';
+		ok = ok && !batch.failed[i];
+	}
+	return ok;
+}
+
+static unsigned long long parseCount(const char* flag, const char* value) {
+	char* end = nullptr;
+	unsigned long long count = value ? std::strtoull(value, &end, 10) : 0;
+	if (value == nullptr || *end != '\0' || count == 0) {
+		std::cerr << "bigcalc: " << flag << " needs a positive integer\n";
+		std::exit(2);
+	}
+	return count;
+}
+
+int main(int argc, char** argv) {
+	unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+	size_t batch_size = 4096;
+	size_t max_bits = Expression::DEFAULT_MAX_BITS;
+	const char* path = nullptr;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (arg == "--threads") {
+			threads = static_cast<unsigned int>(parseCount("--threads", value));
+			++i;
+		} else if (arg == "--batch") {
+			batch_size = parseCount("--batch", value);
+			++i;
+		} else if (arg == "--max-bits") {
+			max_bits = parseCount("--max-bits", value);
+			++i;
+		} else if (arg == "-h" || arg == "--help") {
+			std::cout << "usage: " << argv[0] << " [--threads N] [--batch N] [--max-bits N] [file]\n";
+			return 0;
+		} else if (path == nullptr && arg != "-") {
+			path = argv[i];
+		} else if (arg != "-") {
+			std::cerr << "bigcalc: unexpected argument '" << arg << "'\n";
+			return 2;
+		}
+	}
+
+	std::ifstream file;
+	if (path != nullptr) {
+		file.open(path);
+		if (!file) {
+			std::cerr << "bigcalc: cannot open " << path << "\n";
+			return 2;
+		}
+	}
+	std::istream& in = path != nullptr ? file : std::cin;
+	std::ios::sync_with_stdio(false);
+
+	BatchPool pool(threads, max_bits);
+	Batch batches[2];
+	Batch* current = &batches[0];
+	Batch* following = &batches[1];
+	bool ok = true;
+	bool more = readBatch(in, *current, batch_size);
+	if (more) {
+		pool.start(*current);
+	}
+	while (more) {
+		more = readBatch(in, *following, batch_size);
+		pool.wait();
+		if (more) {
+			pool.start(*following);
+		}
+		ok = writeBatch(std::cout, *current) && ok;
+		std::swap(current, following);
+	}
+	std::cout.flush();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+#include <signal.h>
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "../include/bigint_server.hpp"
+
+// Serves BigInt arithmetic on a Unix domain socket (see bigint_protocol.hpp for the wire format) until SIGINT or
+// SIGTERM, then prints the per-op latency report to stderr.
+//   bigint_server --socket PATH [--threads N] [--batch N] [--contexts N]
+
+static unsigned long long parseCount(const char* flag, const char* value) {
+	char* end = nullptr;
+	unsigned long long count = value ? std::strtoull(value, &end, 10) : 0;
+	if (value == nullptr || *end != '\0' || count == 0) {
+		std::cerr << "bigint_server: " << flag << " needs a positive integer\n";
+		std::exit(2);
+	}
+	return count;
+}
+
+int main(int argc, char** argv) {
+	BigIntServer::Options options;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (arg == "--socket" && value != nullptr) {
+			options.path = value;
+			++i;
+		} else if (arg == "--threads") {
+			options.threads = static_cast<unsigned int>(parseCount("--threads", value));
+			++i;
+		} else if (arg == "--batch") {
+			options.batch = parseCount("--batch", value);
+			++i;
+		} else if (arg == "--contexts") {
+			options.contexts = parseCount("--contexts", value);
+			++i;
+		} else if (arg == "-h" || arg == "--help") {
+			std::cout << "usage: " << argv[0] << " --socket PATH [--threads N] [--batch N] [--contexts N]\n";
+			return 0;
+		} else {
+			std::cerr << "bigint_server: unexpected argument '" << arg << "'\n";
+			return 2;
+		}
+	}
+	if (options.path.empty()) {
+		std::cerr << "bigint_server: --socket PATH is required\n";
+		return 2;
+	}
+
+	// Blocked before any thread starts so every server thread inherits the mask and only sigwait sees the signal.
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	BigIntServer server(options);
+	try {
+		server.start();
+	} catch (const std::exception& e) {
+		std::cerr << "bigint_server: " << e.what() << "\n";
+		return 1;
+	}
+	std::cerr << "bigint_server: listening on " << options.path << "\n";
+	int received = 0;
+	sigwait(&signals, &received);
+	server.stop();
+	std::cerr << server.stats();
+	return 0;
+}